@@ -0,0 +1,163 @@
+/**
+ * The following code validates that the binary data formats of the project are read back as they are written.
+ * - .darc archive: every series is read by its index and by its name, and a missing name is rejected.
+ * - .dbin file: the data is read back with and without the statistics footer, and
+ *   the statistics of the footer match the statistics computed by scanning the data.
+ * It prints the result of each check and returns 1 if any check fails.
+ */
+#include "test_case.hpp"
+#include "../include/data_io.hpp"
+#include "../include/data_archive.hpp"
+#include <cmath>
+
+using namespace std;
+
+int num_failed = 0;
+
+void check(const bool is_passed, const string &check_name)
+{
+    cout << (is_passed ? "PASS " : "FAIL ") << check_name << "\n";
+    num_failed += (is_passed ? 0 : 1);
+}
+
+bool is_same_data(const DATA_SET &loaded_data, span<const double> x_expected, span<const double> y_expected)
+{
+    return loaded_data.size() == x_expected.size() &&
+           equal(x_expected.begin(), x_expected.end(), loaded_data.get_x().begin()) &&
+           equal(y_expected.begin(), y_expected.end(), loaded_data.get_y().begin());
+}
+
+bool is_close(const double lhs, const double rhs)
+{
+    return fabs(lhs - rhs) <= 1e-12 * max(1.0, max(fabs(lhs), fabs(rhs)));
+}
+
+bool is_same_stats(const DATA_STATS &lhs, const DATA_STATS &rhs)
+{
+    // the sums of the footer are merged block by block, so they may differ from a single scan in the last bits
+    return lhs.num_points == rhs.num_points &&
+           is_close(lhs.x_sum, rhs.x_sum) && is_close(lhs.y_sum, rhs.y_sum) &&
+           is_close(lhs.xx_sum, rhs.xx_sum) && is_close(lhs.yy_sum, rhs.yy_sum) && is_close(lhs.xy_sum, rhs.xy_sum) &&
+           lhs.x_min == rhs.x_min && lhs.x_max == rhs.x_max && lhs.y_min == rhs.y_min && lhs.y_max == rhs.y_max;
+}
+
+void test_archive(const filesystem::path &test_dir)
+{
+    vector<string> series_names{"first", "second", "empty", "third"};
+    vector<DATA_SET> series_data{
+        DATA_SET(x_observed, y_observed),
+        DATA_SET(vector<double>(x_observed.begin(), x_observed.begin() + 10), vector<double>(y_observed.begin(), y_observed.begin() + 10)),
+        DATA_SET(),
+        DATA_SET(vector<double>{-1.5, 0.0, 2.25}, vector<double>{3.0, -4.0, 1e300})};
+    string archive_name = (test_dir / "test_data_format.darc").string();
+
+    DATA_IO data_io(IO_MODE::MAPPED);
+    data_io.write_archive(archive_name, series_names, series_data);
+    DATA_ARCHIVE data_archive(archive_name);
+    check(data_archive.size() == series_names.size(), "archive holds every series");
+    for (size_t iter = 0; iter < series_names.size(); iter++)
+    {
+        span<const double> x_expected = series_data[iter].get_x();
+        span<const double> y_expected = series_data[iter].get_y();
+        check(data_archive.get_name(iter) == series_names[iter], "archive name of series " + series_names[iter]);
+        check(is_same_data(data_archive.get_series(iter), x_expected, y_expected), "archive series " + series_names[iter] + " by index");
+        check(is_same_data(data_archive.get_series(string_view(series_names[iter])), x_expected, y_expected),
+              "archive series " + series_names[iter] + " by name");
+    }
+
+    check(data_archive.find_series("missing") == DATA_ARCHIVE::npos, "archive does not find a missing name");
+    bool is_rejected = false;
+    try
+    {
+        data_archive.get_series(string_view("missing"));
+    }
+    catch (const runtime_error &)
+    {
+        is_rejected = true;
+    }
+    check(is_rejected, "archive rejects a missing name");
+    filesystem::remove(archive_name);
+}
+
+void test_dbin(const filesystem::path &test_dir)
+{
+    // more data points than a block of the footer, so the footer holds several blocks
+    vector<double> x_data(2 * DBIN_HEADER::default_stats_block_points + 1000);
+    vector<double> y_data(x_data.size());
+    for (size_t iter = 0; iter < x_data.size(); iter++)
+    {
+        x_data[iter] = static_cast<double>(iter) * 0.5 - 100.0;
+        y_data[iter] = 2.0 * x_data[iter] + 3.0 + y_observed[iter % y_observed.size()] * 1e-3;
+    }
+    DATA_STATS scanned_stats;
+    scanned_stats.accumulate(x_data, y_data);
+
+    DATA_IO data_io(IO_MODE::MAPPED);
+    string footer_name = (test_dir / "test_data_format_footer.dbin").string();
+    data_io.write_dbin(footer_name, x_data, y_data);
+    DATA_SET footer_data;
+    data_io.load_data(footer_name, footer_data);
+    check(is_same_data(footer_data, x_data, y_data), ".dbin with footer holds the same data");
+    const BLOCK_STATS *block_stats = footer_data.get_stats();
+    check(block_stats != nullptr, ".dbin with footer carries statistics");
+    if (block_stats != nullptr)
+    {
+        check(is_same_stats(block_stats->total, scanned_stats), ".dbin footer total matches a scan of the data");
+        check(block_stats->blocks.size() == 3 && is_same_stats(block_stats->merge_blocks(0, 3), scanned_stats),
+              ".dbin footer blocks match a scan of the data");
+    }
+
+    // the same file without the footer: the header no longer refers to it and the file ends after the columns
+    string plain_name = (test_dir / "test_data_format_plain.dbin").string();
+    filesystem::copy_file(footer_name, plain_name, filesystem::copy_options::overwrite_existing);
+    DBIN_HEADER dbin_header;
+    {
+        fstream plain_file(plain_name, ios::in | ios::out | ios::binary);
+        plain_file.read(reinterpret_cast<char *>(&dbin_header), sizeof(DBIN_HEADER));
+        uint64_t stats_offset = dbin_header.stats_offset;
+        dbin_header.stats_offset = 0;
+        dbin_header.stats_block_points = 0;
+        plain_file.seekp(0);
+        plain_file.write(reinterpret_cast<const char *>(&dbin_header), sizeof(DBIN_HEADER));
+        plain_file.close();
+        filesystem::resize_file(plain_name, stats_offset);
+    }
+    DATA_SET plain_data;
+    data_io.load_data(plain_name, plain_data);
+    check(is_same_data(plain_data, x_data, y_data), ".dbin without footer holds the same data");
+    check(plain_data.get_stats() == nullptr, ".dbin without footer carries no statistics");
+
+    // the first range crosses the first two blocks, the second one holds the middle block as a whole
+    for (const auto &[x_low, x_high] : {pair{-10.0, 40000.0}, pair{-10.0, 65500.0}})
+    {
+        string range_name = "[" + to_string(x_low) + ", " + to_string(x_high) + "]";
+        DATA_SET footer_range = footer_data.select_x_range(x_low, x_high);
+        DATA_SET plain_range = plain_data.select_x_range(x_low, x_high);
+        check(is_same_data(footer_range, plain_range.get_x(), plain_range.get_y()),
+              ".dbin x-range " + range_name + " is the same with and without footer");
+        DATA_STATS range_stats;
+        range_stats.accumulate(plain_range.get_x(), plain_range.get_y());
+        check(footer_range.get_stats() != nullptr && is_same_stats(footer_range.get_stats()->total, range_stats),
+              ".dbin x-range " + range_name + " carries the statistics of the selected data");
+    }
+
+    filesystem::remove(footer_name);
+    filesystem::remove(plain_name);
+}
+
+int main()
+{
+    filesystem::path test_dir = filesystem::temp_directory_path();
+    try
+    {
+        test_archive(test_dir);
+        test_dbin(test_dir);
+    }
+    catch (const exception &error)
+    {
+        cout << "FAIL " << error.what() << "\n";
+        num_failed++;
+    }
+    cout << ((num_failed == 0) ? "All checks passed." : "Some checks failed.") << endl;
+    return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+/**
+ * The following code validates the framing of the server mode and its recovery from rejected requests.
+ * Every rejected request must be answered with a single "error" line and consume its announced data lines,
+ * so the next request is read correctly.
+ * It prints the result of each check and returns 1 if any check fails.
+ */
+#include "test_case.hpp"
+#include "../include/request_server.hpp"
+
+using namespace std;
+
+int num_failed = 0;
+
+void check(const bool is_passed, const string &check_name)
+{
+    cout << (is_passed ? "PASS " : "FAIL ") << check_name << "\n";
+    num_failed += (is_passed ? 0 : 1);
+}
+
+string make_fit_request(const string &options)
+{
+    string request = "fit bisquare standardized_residual " + to_string(x_observed.size()) + options + "\n";
+    for (size_t iter = 0; iter < x_observed.size(); iter++)
+    {
+        request += to_string(x_observed[iter]) + " " + to_string(y_observed[iter]) + "\n";
+    }
+    return request;
+}
+
+vector<string> serve_requests(const string &requests)
+{
+    REQUEST_SERVER request_server(2);
+    istringstream request_stream(requests);
+    ostringstream response_stream;
+    request_server.serve(request_stream, response_stream);
+
+    vector<string> response_lines;
+    istringstream response_lines_stream(response_stream.str());
+    string response_line;
+    while (getline(response_lines_stream, response_line))
+    {
+        response_lines.push_back(response_line);
+    }
+    return response_lines;
+}
+
+bool starts_with(const string &line, const string &prefix)
+{
+    return line.compare(0, prefix.size(), prefix) == 0;
+}
+
+void check_recovery(const string &rejected_request, const string &expected_error, const string &check_name)
+{
+    vector<string> response_lines = serve_requests(rejected_request + make_fit_request(""));
+    check(response_lines.size() == 2 &&
+              starts_with(response_lines[0], "error " + expected_error) &&
+              starts_with(response_lines[1], "ok "),
+          check_name);
+}
+
+int main()
+{
+    vector<string> response_lines = serve_requests(make_fit_request("") + "quit\n" + make_fit_request(""));
+    check(response_lines.size() == 1 && starts_with(response_lines[0], "ok "), "fit is answered and quit ends the server");
+
+    size_t num_outliers = 0;
+    response_lines = serve_requests(make_fit_request(" outliers") + make_fit_request(""));
+    if (response_lines.empty() == false && starts_with(response_lines[0], "ok "))
+    {
+        istringstream ok_line(response_lines[0].substr(3));
+        double value = 0;
+        ok_line >> value >> value >> value >> num_outliers;
+    }
+    check(num_outliers > 0 && response_lines.size() == num_outliers + 2 && starts_with(response_lines.back(), "ok "),
+          "fit with outliers is followed by the outlier lines");
+
+    check_recovery("fit bisquare standardized_residual 0\n", "SERVER ERROR - INVALID NUMBER OF DATA POINTS",
+                   "empty fit is rejected");
+    check_recovery("fit bisquare standardized_residual -3\n", "SERVER ERROR - INVALID NUMBER OF DATA POINTS",
+                   "negative count is rejected");
+    check_recovery("fit bisquare standardized_residual 3\n1 2\n3 x\n5 6\n", "SERVER ERROR - INVALID DATA POINT",
+                   "invalid data point consumes the rest of the data lines");
+    check_recovery("fit bisquare standardized_residual 2 verbose\n1 2\n3 4\n", "SERVER ERROR - THERE IS NO SUCH OPTION",
+                   "unknown option consumes the data lines");
+    check_recovery("fit no_such_weight standardized_residual 2\n1 2\n3 4\n", "",
+                   "unknown weight function consumes the data lines");
+    check_recovery("fit_file bisquare standardized_residual no_such_file.dvec\n", "",
+                   "missing file is rejected");
+    check_recovery("estimate bisquare\n", "SERVER ERROR - THERE IS NO SUCH REQUEST", "unknown request is rejected");
+
+    // a huge count must not allocate before the data lines arrive; every following line is a data line
+    response_lines = serve_requests("fit bisquare standardized_residual 4000000000\n1 2\n3 4\nquit\n");
+    check(response_lines.size() == 1 && starts_with(response_lines[0], "error SERVER ERROR - MISSING DATA POINTS"),
+          "huge count reads the announced lines until the input ends");
+
+    cout << ((num_failed == 0) ? "All checks passed." : "Some checks failed.") << endl;
+    return (num_failed == 0) ? 0 : 1;
+}
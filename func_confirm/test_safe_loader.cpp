@@ -0,0 +1,94 @@
+/**
+ * The following code validates that IO_MODE::SAFE accepts the same text as IO_MODE::MAPPED and
+ * rejects only malformed files, reporting the line of the error.
+ * It prints the result of each check and returns 1 if any check fails.
+ */
+#include "../include/data_io.hpp"
+
+using namespace std;
+
+int num_failed = 0;
+
+void check(const bool is_passed, const string &check_name)
+{
+    cout << (is_passed ? "PASS " : "FAIL ") << check_name << "\n";
+    num_failed += (is_passed ? 0 : 1);
+}
+
+string write_text(const filesystem::path &test_dir, const string &file_name, const string &file_text)
+{
+    string path_name = (test_dir / file_name).string();
+    ofstream text_file(path_name, ios::binary);
+    text_file << file_text;
+    return path_name;
+}
+
+void check_accepted(const filesystem::path &test_dir, const string &file_name, const string &file_text, const string &check_name)
+{
+    string path_name = write_text(test_dir, file_name, file_text);
+    DATA_SET mapped_data;
+    DATA_SET safe_data;
+    bool is_loaded = false;
+    try
+    {
+        DATA_IO(IO_MODE::MAPPED).load_data(path_name, mapped_data);
+        DATA_IO(IO_MODE::SAFE).load_data(path_name, safe_data);
+        is_loaded = true;
+    }
+    catch (const exception &error)
+    {
+        cout << error.what();
+    }
+    check(is_loaded == true && safe_data.size() == mapped_data.size() && safe_data.empty() == false &&
+              equal(safe_data.get_x().begin(), safe_data.get_x().end(), mapped_data.get_x().begin()) &&
+              equal(safe_data.get_y().begin(), safe_data.get_y().end(), mapped_data.get_y().begin()),
+          "SAFE accepts " + check_name);
+    filesystem::remove(path_name);
+}
+
+void check_rejected(const filesystem::path &test_dir, const string &file_name, const string &file_text, const size_t error_line,
+                    const string &check_name)
+{
+    string path_name = write_text(test_dir, file_name, file_text);
+    string error_message;
+    try
+    {
+        DATA_SET safe_data;
+        DATA_IO(IO_MODE::SAFE).load_data(path_name, safe_data);
+    }
+    catch (const exception &error)
+    {
+        error_message = error.what();
+    }
+    check(error_message.find("INVALID DATA FORMAT") != string::npos &&
+              error_message.find("Line " + to_string(error_line) + ",") != string::npos,
+          "SAFE rejects " + check_name + " at line " + to_string(error_line));
+    filesystem::remove(path_name);
+}
+
+int main()
+{
+    filesystem::path test_dir = filesystem::temp_directory_path();
+
+    check_accepted(test_dir, "safe_plain.dvec", "3\n1 2\n3 4\n5 6\n", "a counted .dvec file");
+    check_accepted(test_dir, "safe_nocount.dvec", "1 2\n3 4\n5 6\n", "a .dvec file without the count line");
+    check_accepted(test_dir, "safe_leading.dvec", "3\n 1 2\n\t3 4\n  5   6  \n", "data lines with leading and trailing blanks");
+    check_accepted(test_dir, "safe_gap.dvec", "3\n1 2\n\n3 4\n \n5 6\n\n", "empty lines between counted data points");
+    check_accepted(test_dir, "safe_gap_nocount.dvec", "1 2\n\n3 4\n5 6\n", "empty lines between data points without the count line");
+    check_accepted(test_dir, "safe_crlf.dvec", "% comment\r\n2\r\n+1.5 -2e3\r\n3 4\r\n", "comments, CRLF and signs");
+    check_accepted(test_dir, "safe_plain.csv", "2\n1,2\n 3 , 4\n", "a .csv file with blanks around the comma");
+
+    check_rejected(test_dir, "safe_truncated.dvec", "3\n1 2\n3 4\n", 4, "a file that ends before the count");
+    check_rejected(test_dir, "safe_extra.dvec", "2\n1 2\n3 4\n5 6\n", 4, "extra data lines after the count");
+    check_rejected(test_dir, "safe_nan.dvec", "2\n1 2\nnan 4\n", 3, "NaN");
+    check_rejected(test_dir, "safe_inf.dvec", "2\n1 inf\n3 4\n", 2, "infinity");
+    check_rejected(test_dir, "safe_comma.dvec", "2\n1,2\n3 4\n", 2, "a comma in a .dvec file");
+    check_rejected(test_dir, "safe_space.csv", "2\n1,2\n3 4\n", 3, "no comma in a .csv file");
+    check_rejected(test_dir, "safe_garbage.dvec", "2\n1 2\n3 4x\n", 3, "trailing garbage after a number");
+    check_rejected(test_dir, "safe_third.dvec", "2\n1 2\n3 4 5\n", 3, "a third number on a line");
+    check_rejected(test_dir, "safe_missing.dvec", "2\n1 2\n3\n", 3, "a missing Y");
+    check_rejected(test_dir, "safe_range.dvec", "2\n1 2\n3 1e400\n", 3, "a number out of the range of double");
+
+    cout << ((num_failed == 0) ? "All checks passed." : "Some checks failed.") << endl;
+    return (num_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include "PCH.hpp"
+#include "dbin_header.hpp"
+#include <string_view>
+
+/**
+ * @brief
+ * ARCHIVE_HEADER structure is the header at the beginning of .darc file,
+ * the archive format of the project that holds many series of data points in a single file.
+ *
+ * @details
+ * .darc file consists of
+ * - ARCHIVE_HEADER (128 bytes)
+ * - the index, an ARCHIVE_ENTRY of each series in the order of the series, starting at entries_offset
+ * - the hash table of the names, num_buckets 64-bit entries starting at buckets_offset;
+ *   a bucket holds the index of a series plus one, or zero if it is empty
+ * - the names of the series without terminators, names_bytes bytes starting at names_offset
+ * - the column of independent variables (X-Axis) of every series, starting at x_offset
+ * - the column of dependent variables (Y-Axis) of every series, starting at y_offset
+ * The data points of a series are consecutive in both columns, in the order of the series;
+ * therefore, a series is found in O(1) time through the index or the hash table, and
+ * reading every series in order reads the file from the beginning to the end.
+ * Each column starts at a multiple of column_alignment (64 bytes) and is padded with zeros to the next multiple.
+ * The values are written in the byte order of the machine that wrote the file, as .dbin file is.
+ */
+struct ARCHIVE_HEADER
+{
+    char magic[8] = {'P', 'R', 'O', 'J', 'D', 'A', 'R', 'C'};
+    uint32_t version = 1;
+    uint32_t endian_tag = 0x01020304;
+    uint64_t num_series = 0;
+    uint64_t num_data_points = 0; // total number of data points of every series
+    uint32_t dtype = static_cast<uint32_t>(DBIN_DTYPE::FLOAT64);
+    uint32_t column_alignment = 64;
+    uint64_t num_buckets = 0;    // size of the hash table, a power of two larger than num_series
+    uint64_t entries_offset = 0; // byte offsets from the beginning of the file
+    uint64_t buckets_offset = 0;
+    uint64_t names_offset = 0;
+    uint64_t names_bytes = 0;
+    uint64_t x_offset = 0;
+    uint64_t y_offset = 0;
+    uint8_t reserved[32] = {}; // always 0
+};
+static_assert(sizeof(ARCHIVE_HEADER) == 128, "ARCHIVE_HEADER must be 128 bytes");
+
+/**
+ * @brief ARCHIVE_ENTRY structure is the entry of a series in the index of .darc file.
+ *
+ */
+struct ARCHIVE_ENTRY
+{
+    uint64_t name_offset = 0; // byte offset of the name from names_offset
+    uint32_t name_bytes = 0;
+    uint32_t reserved = 0;    // always 0
+    uint64_t first_point = 0; // index of the first data point of the series in the columns
+    uint64_t num_points = 0;
+};
+static_assert(sizeof(ARCHIVE_ENTRY) == 32, "ARCHIVE_ENTRY must be 32 bytes");
+
+/**
+ * @brief
+ * Hashes the name of a series for the hash table of .darc file with 64-bit FNV-1a,
+ * which gives the same value on every platform.
+ *
+ * @param[in] series_name The name of the series.
+ * @return uint64_t
+ */
+inline uint64_t get_archive_hash(std::string_view series_name)
+{
+    uint64_t hash_value = 14695981039346656037ull;
+    for (char letter : series_name)
+    {
+        hash_value ^= static_cast<unsigned char>(letter);
+        hash_value *= 1099511628211ull;
+    }
+    return hash_value;
+}
+
+/**
+ * @brief Gets the number of buckets of the hash table for num_series series, at most half full.
+ *
+ * @param[in] num_series The number of series.
+ * @return uint64_t
+ */
+inline uint64_t get_archive_num_buckets(const uint64_t num_series)
+{
+    uint64_t num_buckets = 1;
+    while (num_buckets < 2 * num_series)
+    {
+        num_buckets *= 2;
+    }
+    return num_buckets;
+}
@@ -0,0 +1,928 @@
+/**
+ * The file contains the asynchronous reader of many files used by Batch Mode.
+ * The files are read with io_uring on Linux if the program is built with PROJ_USE_IO_URING and the kernel allows it;
+ * CMakeLists.txt defines it when linux/io_uring.h is found. Otherwise, they are read on a thread pool.
+ */
+#pragma once
+#include "PCH.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(PROJ_USE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+/**
+ * @class FILE_BUFFER
+ * @brief
+ * FILE_BUFFER class holds the whole content of a file read into memory.
+ *
+ * @details
+ * The buffer is aligned for double, so the columns of .dbin file in the buffer are used in place
+ * as they are in a memory mapping.
+ */
+class FILE_BUFFER
+{
+public:
+    /**
+     * @brief Constructs a new FILE_BUFFER object of file_size bytes without initializing them.
+     *
+     * @param[in] file_size The size of the file in bytes.
+     */
+    explicit FILE_BUFFER(const size_t file_size)
+        : m_storage(new double[file_size / sizeof(double) + 1]), m_size(file_size)
+    {
+    }
+
+    /**
+     * @brief Gets the writable bytes of the buffer.
+     *
+     * @return char*
+     */
+    char *data()
+    {
+        return reinterpret_cast<char *>(this->m_storage.get());
+    }
+
+    /**
+     * @brief Gets the read-only view of the content, valid while the object exists.
+     *
+     * @return std::string_view
+     */
+    std::string_view get_view() const
+    {
+        return std::string_view(reinterpret_cast<const char *>(this->m_storage.get()), this->m_size);
+    }
+
+    /**
+     * @brief Gets the size of the content in bytes.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return this->m_size;
+    }
+
+    /**
+     * @brief Shortens the content, used when the file became shorter while it was read.
+     *
+     * @param[in] file_size The new size in bytes, at most size().
+     */
+    void shrink(const size_t file_size)
+    {
+        this->m_size = std::min(this->m_size, file_size);
+    }
+
+private:
+    std::unique_ptr<double[]> m_storage;
+    size_t m_size;
+};
+
+/**
+ * @class ASYNC_FILE_READER
+ * @brief
+ * ASYNC_FILE_READER class reads a list of files into memory in the background while the caller parses
+ * and computes the files that have already arrived.
+ *
+ * @details
+ * A background thread reads the files in the order of the list and keeps up to queue_depth reads in flight,
+ * so a fast storage device serves many requests at once instead of one per blocking read.
+ * - With io_uring, the reads are submitted to a single ring and the buffers are handed over as they complete.
+ * - Without io_uring, e.g. on other platforms or when the kernel forbids it, queue_depth threads of a THREAD_POOL
+ *   read the files with blocking reads.
+ * Each file is opened once and its type and size are taken from the open file, instead of
+ * checking the path with separate calls before opening it.
+ * At most twice queue_depth files, and at most max_ahead_bytes bytes of files, are read ahead of the first file
+ * that has not been taken by get_file(), so the memory in use depends neither on the number nor on the size of the files.
+ * A file larger than max_ahead_bytes is read only when no other file is waiting; large files are better mapped.
+ * get_file() can be called concurrently, each file once; calling it in about the order of the list keeps the reads ahead,
+ * and a file far ahead of the others is read after the files before it.
+ * A file that cannot be read does not stop the others; get_file() throws its exception.
+ */
+class ASYNC_FILE_READER
+{
+public:
+    /**
+     * @brief The default number of reads in flight.
+     *
+     */
+    static constexpr uint32_t default_queue_depth = 32;
+
+    /**
+     * @brief The default number of bytes read or being read ahead of the files taken.
+     *
+     */
+    static constexpr size_t default_max_ahead_bytes = size_t(256) << 20;
+
+    /**
+     * @brief Constructs a new ASYNC_FILE_READER object and starts reading the files in the background.
+     *
+     * @param[in] file_names Paths to the files in the order they will be taken.
+     * @param[in] queue_depth The number of reads in flight, zero means default_queue_depth.
+     * @param[in] max_ahead_bytes The number of bytes read ahead at most, zero means default_max_ahead_bytes.
+     */
+    explicit ASYNC_FILE_READER(std::vector<std::string> file_names, const uint32_t queue_depth = default_queue_depth,
+                               const size_t max_ahead_bytes = default_max_ahead_bytes)
+        : m_file_names(std::move(file_names)), m_slots(m_file_names.size()),
+          m_queue_depth((queue_depth == 0) ? default_queue_depth : queue_depth),
+          m_max_ahead_bytes((max_ahead_bytes == 0) ? default_max_ahead_bytes : max_ahead_bytes)
+    {
+        this->m_max_ahead = 2 * static_cast<size_t>(this->m_queue_depth);
+#if defined(PROJ_USE_IO_URING)
+        this->m_is_io_uring = this->m_ring.setup(this->m_queue_depth);
+#endif
+        this->m_reader = std::thread([this]()
+                                     { this->run_reader(); });
+    }
+
+    ASYNC_FILE_READER(const ASYNC_FILE_READER &) = delete;
+    ASYNC_FILE_READER &operator=(const ASYNC_FILE_READER &) = delete;
+
+    /**
+     * @brief Stops reading the files that have not started, waits for the reads in flight and releases the buffers.
+     *
+     */
+    ~ASYNC_FILE_READER()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            this->m_is_stopped = true;
+        }
+        this->m_window_cv.notify_all();
+        this->m_reader.join();
+    }
+
+    /**
+     * @brief Gets the number of files in the list.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return this->m_file_names.size();
+    }
+
+    /**
+     * @brief Checks whether the files are read with io_uring instead of the thread pool.
+     *
+     * @return true When io_uring is used.
+     * @return false Otherwise.
+     */
+    bool is_io_uring() const
+    {
+        return this->m_is_io_uring;
+    }
+
+    /**
+     * @brief
+     * Waits until a file is read and takes its content.
+     * It throws the exception raised while the file was read, e.g. the file does not exist or is not a regular file.
+     *
+     * @param[in] file_index The index of the file in the list, taken once.
+     * @return std::shared_ptr<const FILE_BUFFER>
+     */
+    std::shared_ptr<const FILE_BUFFER> get_file(const size_t file_index)
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        FILE_SLOT &file_slot = this->m_slots.at(file_index);
+        if (file_index >= this->m_num_requested)
+        {
+            this->m_num_requested = file_index + 1; // the files before it are read even if they are beyond the window
+            this->m_window_cv.notify_all();
+        }
+        this->m_ready_cv.wait(lock, [&file_slot]()
+                              { return file_slot.is_ready; });
+        std::shared_ptr<const FILE_BUFFER> file_buffer = std::move(file_slot.file_buffer);
+        std::exception_ptr read_error = file_slot.read_error;
+        file_slot.is_taken = true;
+        this->m_bytes_ahead -= file_slot.num_bytes;
+        while (this->m_first_untaken < this->m_slots.size() && this->m_slots[this->m_first_untaken].is_taken == true)
+        {
+            this->m_first_untaken++;
+        }
+        lock.unlock();
+        this->m_window_cv.notify_all();
+
+        if (read_error != nullptr)
+        {
+            std::rethrow_exception(read_error);
+        }
+        return file_buffer;
+    }
+
+private:
+    /**
+     * @brief State of a file in the list, guarded by m_mutex.
+     *
+     */
+    struct FILE_SLOT
+    {
+        std::shared_ptr<FILE_BUFFER> file_buffer;
+        std::exception_ptr read_error;
+        size_t num_bytes = 0; // bytes reserved by reserve_bytes() until the file is taken
+        bool is_ready = false;
+        bool is_taken = false;
+    };
+
+    /**
+     * @brief A file opened for reading.
+     *
+     */
+    struct OPENED_FILE
+    {
+#if defined(_WIN32)
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+#else
+        int file_descriptor = -1;
+#endif
+        size_t file_size = 0;
+        std::shared_ptr<FILE_BUFFER> file_buffer; // allocated once the bytes are reserved
+    };
+
+#if defined(PROJ_USE_IO_URING)
+    /**
+     * @brief
+     * A submission queue and a completion queue of io_uring shared with the kernel, used by the background thread only.
+     * It is set up with the system calls directly, so the program does not depend on liburing.
+     */
+    class URING_QUEUE
+    {
+    public:
+        URING_QUEUE() = default;
+        URING_QUEUE(const URING_QUEUE &) = delete;
+        URING_QUEUE &operator=(const URING_QUEUE &) = delete;
+
+        /**
+         * @brief Unmaps the queues and closes the ring.
+         *
+         */
+        ~URING_QUEUE()
+        {
+            if (this->m_sqes != nullptr)
+            {
+                munmap(this->m_sqes, this->m_sqes_bytes);
+            }
+            if (this->m_cq_ring != nullptr && this->m_cq_ring != this->m_sq_ring)
+            {
+                munmap(this->m_cq_ring, this->m_cq_bytes);
+            }
+            if (this->m_sq_ring != nullptr)
+            {
+                munmap(this->m_sq_ring, this->m_sq_bytes);
+            }
+            if (this->m_ring_fd >= 0)
+            {
+                close(this->m_ring_fd);
+            }
+        }
+
+        /**
+         * @brief Creates the ring and maps its queues.
+         *
+         * @param[in] num_entries The number of submission queue entries.
+         * @return true When io_uring can be used.
+         * @return false When the kernel does not support or forbids io_uring.
+         */
+        bool setup(const uint32_t num_entries)
+        {
+            io_uring_params ring_params;
+            std::memset(&ring_params, 0, sizeof(ring_params));
+            this->m_ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, num_entries, &ring_params));
+            if (this->m_ring_fd < 0)
+            {
+                return false;
+            }
+
+            this->m_sq_bytes = ring_params.sq_off.array + ring_params.sq_entries * sizeof(uint32_t);
+            this->m_cq_bytes = ring_params.cq_off.cqes + ring_params.cq_entries * sizeof(io_uring_cqe);
+            bool is_single_mmap = (ring_params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (is_single_mmap == true)
+            {
+                this->m_sq_bytes = std::max(this->m_sq_bytes, this->m_cq_bytes);
+            }
+            this->m_sq_ring = map_ring(this->m_sq_bytes, IORING_OFF_SQ_RING);
+            if (this->m_sq_ring == nullptr)
+            {
+                return false;
+            }
+            this->m_cq_ring = (is_single_mmap == true) ? this->m_sq_ring : map_ring(this->m_cq_bytes, IORING_OFF_CQ_RING);
+            this->m_sqes_bytes = ring_params.sq_entries * sizeof(io_uring_sqe);
+            this->m_sqes = static_cast<io_uring_sqe *>(map_ring(this->m_sqes_bytes, IORING_OFF_SQES));
+            if (this->m_cq_ring == nullptr || this->m_sqes == nullptr)
+            {
+                return false;
+            }
+
+            char *sq_ring = static_cast<char *>(this->m_sq_ring);
+            char *cq_ring = static_cast<char *>(this->m_cq_ring);
+            this->m_sq_tail = reinterpret_cast<uint32_t *>(sq_ring + ring_params.sq_off.tail);
+            this->m_sq_mask = *reinterpret_cast<uint32_t *>(sq_ring + ring_params.sq_off.ring_mask);
+            this->m_sq_array = reinterpret_cast<uint32_t *>(sq_ring + ring_params.sq_off.array);
+            this->m_cq_head = reinterpret_cast<uint32_t *>(cq_ring + ring_params.cq_off.head);
+            this->m_cq_tail = reinterpret_cast<uint32_t *>(cq_ring + ring_params.cq_off.tail);
+            this->m_cq_mask = *reinterpret_cast<uint32_t *>(cq_ring + ring_params.cq_off.ring_mask);
+            this->m_cqes = reinterpret_cast<io_uring_cqe *>(cq_ring + ring_params.cq_off.cqes);
+
+            // a sandbox may allow creating the ring but not submitting to it; a no-op is submitted and waited for
+            io_uring_sqe ring_sqe;
+            std::memset(&ring_sqe, 0, sizeof(ring_sqe));
+            ring_sqe.opcode = IORING_OP_NOP;
+            this->push_entry(ring_sqe);
+            if (this->enter(1) == false)
+            {
+                return false;
+            }
+            bool is_completed = false;
+            this->reap([&is_completed](uint64_t, int32_t nop_result)
+                       { is_completed = (nop_result == 0); });
+            return is_completed;
+        }
+
+        /**
+         * @brief Queues a read of a file into a buffer; it is submitted by the next enter().
+         *
+         * @param[in] file_descriptor The file to be read.
+         * @param[in] io_vector The buffer, which must be kept until enter() returns.
+         * @param[in] file_offset The byte offset of the read in the file.
+         * @param[in] user_data The value given back with the completion.
+         */
+        void push_read(const int file_descriptor, const iovec *io_vector, const uint64_t file_offset, const uint64_t user_data)
+        {
+            io_uring_sqe ring_sqe;
+            std::memset(&ring_sqe, 0, sizeof(ring_sqe));
+            ring_sqe.opcode = IORING_OP_READV; // READV is supported from Linux 5.1, READ only from 5.6
+            ring_sqe.fd = file_descriptor;
+            ring_sqe.addr = reinterpret_cast<uint64_t>(io_vector);
+            ring_sqe.len = 1;
+            ring_sqe.off = file_offset;
+            ring_sqe.user_data = user_data;
+            this->push_entry(ring_sqe);
+        }
+
+        /**
+         * @brief Submits the queued reads and waits until at least min_complete reads are completed.
+         *
+         * @param[in] min_complete The number of completions to wait for.
+         * @return true When the call is succeeded.
+         * @return false When the ring cannot be used any more.
+         */
+        bool enter(const uint32_t min_complete)
+        {
+            while (this->m_num_queued > 0 || min_complete > 0)
+            {
+                uint32_t enter_flags = (min_complete > 0) ? IORING_ENTER_GETEVENTS : 0;
+                long num_submitted = syscall(__NR_io_uring_enter, this->m_ring_fd, this->m_num_queued, min_complete, enter_flags, nullptr, 0);
+                if (num_submitted < 0)
+                {
+                    if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                this->m_num_queued -= static_cast<uint32_t>(num_submitted);
+                if (this->m_num_queued == 0)
+                {
+                    return true;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Calls complete_read(user_data, result) for every completed read and releases the completions.
+         *
+         * @tparam FUNCTION A callable object with signature void(uint64_t, int32_t).
+         * @param[in] complete_read The function called for a completed read.
+         */
+        template <typename FUNCTION>
+        void reap(FUNCTION &&complete_read)
+        {
+            uint32_t cq_head = std::atomic_ref<uint32_t>(*this->m_cq_head).load(std::memory_order_relaxed);
+            uint32_t cq_tail = std::atomic_ref<uint32_t>(*this->m_cq_tail).load(std::memory_order_acquire);
+            while (cq_head != cq_tail)
+            {
+                io_uring_cqe ring_cqe = this->m_cqes[cq_head & this->m_cq_mask];
+                cq_head++;
+                std::atomic_ref<uint32_t>(*this->m_cq_head).store(cq_head, std::memory_order_release);
+                complete_read(ring_cqe.user_data, ring_cqe.res);
+            }
+        }
+
+    private:
+        int m_ring_fd = -1;
+        void *m_sq_ring = nullptr;
+        void *m_cq_ring = nullptr;
+        io_uring_sqe *m_sqes = nullptr;
+        size_t m_sq_bytes = 0;
+        size_t m_cq_bytes = 0;
+        size_t m_sqes_bytes = 0;
+        uint32_t *m_sq_tail = nullptr;
+        uint32_t m_sq_mask = 0;
+        uint32_t *m_sq_array = nullptr;
+        uint32_t *m_cq_head = nullptr;
+        uint32_t *m_cq_tail = nullptr;
+        uint32_t m_cq_mask = 0;
+        io_uring_cqe *m_cqes = nullptr;
+        uint32_t m_num_queued = 0; // pushed but not submitted
+
+        /**
+         * @brief Copies an entry into the submission queue; it is submitted by the next enter().
+         *
+         * @param[in] ring_sqe The submission queue entry.
+         */
+        void push_entry(const io_uring_sqe &ring_sqe)
+        {
+            uint32_t sq_tail = *this->m_sq_tail;
+            uint32_t sqe_index = sq_tail & this->m_sq_mask;
+            this->m_sqes[sqe_index] = ring_sqe;
+            this->m_sq_array[sqe_index] = sqe_index;
+            std::atomic_ref<uint32_t>(*this->m_sq_tail).store(sq_tail + 1, std::memory_order_release);
+            this->m_num_queued++;
+        }
+
+        /**
+         * @brief Maps a region of the ring, returns null if it fails.
+         *
+         * @param[in] region_bytes The size of the region.
+         * @param[in] region_offset IORING_OFF_SQ_RING, IORING_OFF_CQ_RING or IORING_OFF_SQES.
+         * @return void*
+         */
+        void *map_ring(const size_t region_bytes, const uint64_t region_offset)
+        {
+            void *mapped_address = mmap(nullptr, region_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                        this->m_ring_fd, static_cast<off_t>(region_offset));
+            return (mapped_address == MAP_FAILED) ? nullptr : mapped_address;
+        }
+    };
+
+    std::vector<std::shared_ptr<FILE_BUFFER>> m_abandoned_buffers; // reads in flight when the ring failed, kept until it is closed
+    URING_QUEUE m_ring;
+#endif
+
+    std::vector<std::string> m_file_names;
+    std::vector<FILE_SLOT> m_slots;
+    uint32_t m_queue_depth;
+    size_t m_max_ahead = 0;     // files read ahead of m_first_untaken at most
+    size_t m_first_untaken = 0; // index of the first file that has not been taken
+    size_t m_num_requested = 0; // one past the largest index given to get_file()
+    size_t m_max_ahead_bytes;   // bytes read ahead of m_first_untaken at most
+    size_t m_bytes_ahead = 0;   // bytes of the files being read or waiting to be taken
+    bool m_is_stopped = false;
+    bool m_is_io_uring = false;
+    std::mutex m_mutex;
+    std::condition_variable m_ready_cv;  // a file is ready
+    std::condition_variable m_window_cv; // a file is taken or the reader is stopped
+    std::thread m_reader;
+
+    /**
+     * @brief Main function of the background thread, reads every file with io_uring or the thread pool.
+     *
+     */
+    void run_reader()
+    {
+#if defined(PROJ_USE_IO_URING)
+        if (this->m_is_io_uring == true)
+        {
+            this->read_io_uring();
+            return;
+        }
+#endif
+        this->read_thread_pool();
+    }
+
+    /**
+     * @brief Checks whether a file can be read without exceeding the files read ahead.
+     *
+     * @param[in] file_index The index of the file.
+     * @param[in] is_blocking Waits until the file can be read if it is true.
+     * @return true When the file can be read.
+     * @return false When it cannot be read yet (not blocking) or the reader is stopped.
+     */
+    bool is_in_window(const size_t file_index, const bool is_blocking)
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        auto is_open = [this, file_index]()
+        { return this->m_is_stopped == true || file_index < this->m_first_untaken + this->m_max_ahead ||
+                 file_index < this->m_num_requested; };
+        if (is_blocking == true)
+        {
+            this->m_window_cv.wait(lock, is_open);
+        }
+        return this->m_is_stopped == false && is_open() == true;
+    }
+
+    /**
+     * @brief
+     * Reserves the bytes of an opened file before its buffer is allocated, without exceeding max_ahead_bytes.
+     * A file is always allowed when nothing else is reserved or a file after it has been requested by get_file(),
+     * so a file larger than max_ahead_bytes does not stop the reader.
+     *
+     * @param[in] file_index The index of the file.
+     * @param[in] num_bytes The size of the file in bytes.
+     * @param[in] is_blocking Waits until the bytes can be reserved if it is true.
+     * @return true When the bytes are reserved.
+     * @return false When they cannot be reserved yet (not blocking) or the reader is stopped.
+     */
+    bool reserve_bytes(const size_t file_index, const size_t num_bytes, const bool is_blocking)
+    {
+        std::unique_lock<std::mutex> lock(this->m_mutex);
+        auto is_free = [this, file_index, num_bytes]()
+        { return this->m_is_stopped == true || this->m_bytes_ahead == 0 ||
+                 this->m_bytes_ahead + num_bytes <= this->m_max_ahead_bytes || file_index < this->m_num_requested; };
+        if (is_blocking == true)
+        {
+            this->m_window_cv.wait(lock, is_free);
+        }
+        if (this->m_is_stopped == true || is_free() == false)
+        {
+            return false;
+        }
+        this->m_bytes_ahead += num_bytes;
+        this->m_slots[file_index].num_bytes = num_bytes;
+        return true;
+    }
+
+    /**
+     * @brief Hands over the content of a file, or the exception raised while reading it, to get_file().
+     *
+     * @param[in] file_index The index of the file.
+     * @param[in] file_buffer The content of the file, null if it failed.
+     * @param[in] read_error The exception raised while reading the file, null if it succeeded.
+     */
+    void complete_file(const size_t file_index, std::shared_ptr<FILE_BUFFER> file_buffer, std::exception_ptr read_error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->m_mutex);
+            FILE_SLOT &file_slot = this->m_slots[file_index];
+            file_slot.file_buffer = std::move(file_buffer);
+            file_slot.read_error = read_error;
+            file_slot.is_ready = true;
+        }
+        this->m_ready_cv.notify_all();
+    }
+
+    /**
+     * @brief
+     * Opens a file and takes its size from the open file, with a single open instead of checking the path beforehand.
+     * It throws a runtime exception if the file cannot be opened or is not a regular file.
+     *
+     * @param[in] file_name Path to the file.
+     * @return OPENED_FILE
+     */
+    static OPENED_FILE open_file(const std::string &file_name)
+    {
+        OPENED_FILE opened_file;
+#if defined(_WIN32)
+        opened_file.file_handle = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (opened_file.file_handle == INVALID_HANDLE_VALUE)
+        {
+            throw_read_error(file_name, "The file cannot be opened.");
+        }
+        LARGE_INTEGER file_size;
+        if (GetFileType(opened_file.file_handle) != FILE_TYPE_DISK || GetFileSizeEx(opened_file.file_handle, &file_size) == 0)
+        {
+            CloseHandle(opened_file.file_handle);
+            throw_read_error(file_name, "The path is not a regular file.");
+        }
+        opened_file.file_size = static_cast<size_t>(file_size.QuadPart);
+#else
+        opened_file.file_descriptor = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+        if (opened_file.file_descriptor < 0)
+        {
+            throw_read_error(file_name, std::strerror(errno));
+        }
+        struct stat file_status;
+        if (fstat(opened_file.file_descriptor, &file_status) != 0 || S_ISREG(file_status.st_mode) == false)
+        {
+            close(opened_file.file_descriptor);
+            throw_read_error(file_name, "The path is not a regular file.");
+        }
+        opened_file.file_size = static_cast<size_t>(file_status.st_size);
+#endif
+        return opened_file;
+    }
+
+    /**
+     * @brief Closes a file opened by open_file().
+     *
+     * @param[in] opened_file The file to be closed.
+     */
+    static void close_file(const OPENED_FILE &opened_file)
+    {
+#if defined(_WIN32)
+        CloseHandle(opened_file.file_handle);
+#else
+        close(opened_file.file_descriptor);
+#endif
+    }
+
+    /**
+     * @brief
+     * Reads a whole opened file into a new buffer with blocking reads and closes it, used by the thread pool.
+     * It throws a runtime exception if the file cannot be read.
+     *
+     * @param[in] opened_file The file opened by open_file().
+     * @param[in] file_name Path to the file.
+     * @return std::shared_ptr<FILE_BUFFER>
+     */
+    static std::shared_ptr<FILE_BUFFER> read_file(OPENED_FILE &opened_file, const std::string &file_name)
+    {
+        try
+        {
+            opened_file.file_buffer = std::make_shared<FILE_BUFFER>(opened_file.file_size);
+        }
+        catch (...)
+        {
+            close_file(opened_file);
+            throw;
+        }
+        FILE_BUFFER &file_buffer = *opened_file.file_buffer;
+        size_t num_read = 0;
+        while (num_read < file_buffer.size())
+        {
+            size_t num_requested = std::min(file_buffer.size() - num_read, max_read_bytes);
+#if defined(_WIN32)
+            DWORD num_new = 0;
+            if (ReadFile(opened_file.file_handle, file_buffer.data() + num_read, static_cast<DWORD>(num_requested), &num_new, nullptr) == 0)
+            {
+                close_file(opened_file);
+                throw_read_error(file_name, "The file cannot be read.");
+            }
+#else
+            ssize_t num_new = pread(opened_file.file_descriptor, file_buffer.data() + num_read, num_requested, static_cast<off_t>(num_read));
+            if (num_new < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (num_new < 0)
+            {
+                int read_errno = errno;
+                close_file(opened_file);
+                throw_read_error(file_name, std::strerror(read_errno));
+            }
+#endif
+            if (num_new == 0)
+            {
+                file_buffer.shrink(num_read); // the file became shorter after it was opened
+                break;
+            }
+            num_read += static_cast<size_t>(num_new);
+        }
+        close_file(opened_file);
+        return std::move(opened_file.file_buffer);
+    }
+
+    /**
+     * @brief Waits until a file is in the window and its bytes are reserved, then reads it with blocking reads.
+     *
+     * @param[in] file_index The index of the file.
+     */
+    void read_next_file(const size_t file_index)
+    {
+        if (this->is_in_window(file_index, true) == false)
+        {
+            return;
+        }
+        try
+        {
+            OPENED_FILE opened_file = open_file(this->m_file_names[file_index]);
+            if (this->reserve_bytes(file_index, opened_file.file_size, true) == false)
+            {
+                close_file(opened_file);
+                return;
+            }
+            this->complete_file(file_index, read_file(opened_file, this->m_file_names[file_index]), nullptr);
+        }
+        catch (...)
+        {
+            this->complete_file(file_index, nullptr, std::current_exception());
+        }
+    }
+
+    /**
+     * @brief Reads the files on queue_depth threads of a THREAD_POOL, in the order of the list.
+     *
+     */
+    void read_thread_pool()
+    {
+        THREAD_POOL thread_pool(this->m_queue_depth);
+        thread_pool.parallel_for(this->m_file_names.size(), [this](size_t file_index, uint32_t)
+                                 { this->read_next_file(file_index); });
+    }
+
+#if defined(PROJ_USE_IO_URING)
+    /**
+     * @brief
+     * Reads the files with io_uring, in the order of the list, keeping up to queue_depth reads in flight.
+     * A read that returns less than requested is submitted again for the rest of the file.
+     */
+    void read_io_uring()
+    {
+        struct READ_REQUEST
+        {
+            size_t file_index = 0;
+            OPENED_FILE opened_file;
+            size_t num_read = 0;
+            iovec io_vector{};
+        };
+        std::vector<READ_REQUEST> read_requests(this->m_queue_depth);
+        std::vector<uint32_t> free_requests(this->m_queue_depth);
+        std::iota(free_requests.rbegin(), free_requests.rend(), uint32_t(0));
+
+        auto push_request = [this, &read_requests](uint32_t request_index)
+        {
+            READ_REQUEST &read_request = read_requests[request_index];
+            FILE_BUFFER &file_buffer = *read_request.opened_file.file_buffer;
+            read_request.io_vector.iov_base = file_buffer.data() + read_request.num_read;
+            read_request.io_vector.iov_len = std::min(file_buffer.size() - read_request.num_read, max_read_bytes);
+            this->m_ring.push_read(read_request.opened_file.file_descriptor, &read_request.io_vector,
+                                   read_request.num_read, request_index);
+        };
+        auto finish_request = [this, &read_requests, &free_requests](uint32_t request_index, std::exception_ptr read_error)
+        {
+            READ_REQUEST &read_request = read_requests[request_index];
+            close_file(read_request.opened_file);
+            this->complete_file(read_request.file_index,
+                                (read_error == nullptr) ? std::move(read_request.opened_file.file_buffer) : nullptr, read_error);
+            read_request = READ_REQUEST();
+            free_requests.push_back(request_index);
+        };
+        auto complete_read = [&](uint64_t user_data, int32_t read_result)
+        {
+            uint32_t request_index = static_cast<uint32_t>(user_data);
+            READ_REQUEST &read_request = read_requests[request_index];
+            FILE_BUFFER &file_buffer = *read_request.opened_file.file_buffer;
+            if (read_result == -EINTR || read_result == -EAGAIN)
+            {
+                push_request(request_index);
+                return;
+            }
+            if (read_result < 0)
+            {
+                std::exception_ptr read_error;
+                try
+                {
+                    throw_read_error(this->m_file_names[read_request.file_index], std::strerror(-read_result));
+                }
+                catch (...)
+                {
+                    read_error = std::current_exception();
+                }
+                finish_request(request_index, read_error);
+                return;
+            }
+            if (read_result == 0)
+            {
+                file_buffer.shrink(read_request.num_read); // the file became shorter after it was opened
+            }
+            read_request.num_read += static_cast<size_t>(read_result);
+            if (read_request.num_read < file_buffer.size())
+            {
+                push_request(request_index);
+                return;
+            }
+            finish_request(request_index, nullptr);
+        };
+
+        size_t next_file = 0;
+        OPENED_FILE pending_file; // next_file, opened but waiting for its bytes to be reserved
+        bool is_pending = false;
+        while (true)
+        {
+            bool is_stopped = false;
+            while (free_requests.empty() == false && next_file < this->m_file_names.size())
+            {
+                bool is_idle = (free_requests.size() == read_requests.size());
+                size_t file_index = next_file;
+                try
+                {
+                    if (is_pending == false)
+                    {
+                        if (this->is_in_window(file_index, is_idle) == false)
+                        {
+                            is_stopped = is_idle;
+                            break;
+                        }
+                        pending_file = open_file(this->m_file_names[file_index]);
+                        is_pending = true;
+                    }
+                    if (this->reserve_bytes(file_index, pending_file.file_size, is_idle) == false)
+                    {
+                        is_stopped = is_idle;
+                        break;
+                    }
+                    OPENED_FILE opened_file = std::move(pending_file);
+                    is_pending = false;
+                    next_file++;
+                    if (opened_file.file_size == 0)
+                    {
+                        this->complete_file(file_index, read_file(opened_file, this->m_file_names[file_index]), nullptr);
+                        continue;
+                    }
+                    try
+                    {
+                        opened_file.file_buffer = std::make_shared<FILE_BUFFER>(opened_file.file_size);
+                    }
+                    catch (...)
+                    {
+                        close_file(opened_file);
+                        throw;
+                    }
+                    uint32_t request_index = free_requests.back();
+                    free_requests.pop_back();
+                    read_requests[request_index].file_index = file_index;
+                    read_requests[request_index].opened_file = std::move(opened_file);
+                    push_request(request_index);
+                }
+                catch (...)
+                {
+                    next_file = file_index + 1;
+                    this->complete_file(file_index, nullptr, std::current_exception());
+                }
+            }
+
+            uint32_t num_in_flight = static_cast<uint32_t>(read_requests.size() - free_requests.size());
+            if (num_in_flight == 0 && (next_file == this->m_file_names.size() || is_stopped == true))
+            {
+                break;
+            }
+            if (this->m_ring.enter((num_in_flight > 0) ? 1 : 0) == false)
+            {
+                break; // the files in flight are given to the thread pool below
+            }
+            this->m_ring.reap(complete_read);
+        }
+        if (is_pending == true)
+        {
+            close_file(pending_file); // reopened below if the ring failed
+        }
+
+        // the ring failed; the files in flight and the remaining files are read with blocking reads
+        for (size_t request_index = 0; request_index < read_requests.size(); request_index++)
+        {
+            if (read_requests[request_index].opened_file.file_buffer != nullptr)
+            {
+                size_t file_index = read_requests[request_index].file_index;
+                close_file(read_requests[request_index].opened_file);
+                this->m_abandoned_buffers.push_back(std::move(read_requests[request_index].opened_file.file_buffer));
+                try
+                {
+                    OPENED_FILE opened_file = open_file(this->m_file_names[file_index]); // its bytes are already reserved
+                    this->complete_file(file_index, read_file(opened_file, this->m_file_names[file_index]), nullptr);
+                }
+                catch (...)
+                {
+                    this->complete_file(file_index, nullptr, std::current_exception());
+                }
+            }
+        }
+        for (; next_file < this->m_file_names.size(); next_file++)
+        {
+            this->read_next_file(next_file);
+        }
+    }
+#endif
+
+    /**
+     * @brief The largest number of bytes requested by a read, below the limit of a single read on Linux.
+     *
+     */
+    static constexpr size_t max_read_bytes = size_t(1) << 30;
+
+    /**
+     * @brief The function throws a runtime exception for a file that cannot be read.
+     *
+     * @param[in] file_name Path to the file.
+     * @param[in] reason The reason the file cannot be read.
+     */
+    [[noreturn]] static void throw_read_error(const std::string &file_name, const std::string &reason)
+    {
+        std::string error_message =
+            "READ ERROR - FAILED TO READ A FILE.\n"
+            "Cannot read " + file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+};
@@ -0,0 +1,619 @@
+/**
+ * The file contains gzip and zstd compression of data files.
+ * gzip is available if the program is built with PROJ_USE_ZLIB, and zstd if it is built with PROJ_USE_ZSTD;
+ * CMakeLists.txt defines them when the libraries are found.
+ */
+#pragma once
+#include "PCH.hpp"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#if defined(PROJ_USE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(PROJ_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+/**
+ * @brief
+ * ENUM CLASS that contains the compression formats of data files, chosen by the last extension of the file name.
+ */
+enum class COMPRESSION
+{
+    NONE,
+    GZIP, // .gz
+    ZSTD  // .zst
+};
+
+/**
+ * @brief Gets the compression format of a file from the last extension of its name.
+ *
+ * @param[in] file_path Path to the file.
+ * @return COMPRESSION
+ */
+inline COMPRESSION get_compression(const std::filesystem::path &file_path)
+{
+    if (file_path.extension() == ".gz")
+    {
+        return COMPRESSION::GZIP;
+    }
+    if (file_path.extension() == ".zst")
+    {
+        return COMPRESSION::ZSTD;
+    }
+    return COMPRESSION::NONE;
+}
+
+/**
+ * @brief Removes the compression extension from a file name, e.g. data.dvec.gz into data.dvec.
+ *
+ * @param[in] file_path Path to the file.
+ * @return std::filesystem::path
+ */
+inline std::filesystem::path remove_compression_extension(const std::filesystem::path &file_path)
+{
+    if (get_compression(file_path) == COMPRESSION::NONE)
+    {
+        return file_path;
+    }
+    return file_path.parent_path() / file_path.stem();
+}
+
+/**
+ * @brief Checks that the program is built with the library of the compression format.
+ *
+ * @param[in] compression The compression format.
+ * @return true When the format can be read and written.
+ * @return false Otherwise.
+ */
+inline bool is_compression_supported(const COMPRESSION compression)
+{
+    switch (compression)
+    {
+    case COMPRESSION::NONE:
+        return true;
+    case COMPRESSION::GZIP:
+#if defined(PROJ_USE_ZLIB)
+        return true;
+#else
+        return false;
+#endif
+    case COMPRESSION::ZSTD:
+#if defined(PROJ_USE_ZSTD)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * @brief
+ * Throws a runtime exception if the program is built without the library of the compression format of the file.
+ *
+ * @param[in] file_name Path to the file.
+ * @param[in] error_type Type of the error, "READ ERROR" or "WRITE ERROR".
+ */
+inline void validate_compression_supported(const std::string &file_name, const std::string &error_type)
+{
+    if (is_compression_supported(get_compression(file_name)) == false)
+    {
+        std::string error_message =
+            error_type + " - COMPRESSION IS NOT SUPPORTED.\n"
+            "The program is built without the library of " + std::filesystem::path(file_name).extension().string() +
+            " files, cannot process " + file_name + "\n";
+        throw std::runtime_error(error_message);
+    }
+}
+
+/**
+ * @class DECOMPRESS_STREAM
+ * @brief
+ * DECOMPRESS_STREAM class decompresses .gz or .zst file on its own thread while the caller reads the decompressed bytes.
+ *
+ * @details
+ * The worker thread reads and decompresses the file into chunks of chunk_bytes bytes and
+ * queues up to max_queued_chunks of them; therefore, decompression is pipelined with parsing of the caller and
+ * the memory is bounded regardless of the size of the file.
+ * Concatenated gzip members and zstd frames are read one after another, as gzip and zstd tools do.
+ * An error of the worker thread is thrown by read() after the chunks decompressed before it.
+ */
+class DECOMPRESS_STREAM
+{
+public:
+    static constexpr size_t chunk_bytes = size_t(1) << 20;
+    static constexpr size_t max_queued_chunks = 4;
+
+    /**
+     * @brief Opens the file and starts decompressing it on the worker thread.
+     * It throws a runtime exception if the file cannot be opened or its compression format is not supported.
+     *
+     * @param[in] file_name Path to .gz or .zst file.
+     */
+    explicit DECOMPRESS_STREAM(const std::string &file_name)
+        : m_file_name(file_name), m_compression(get_compression(file_name))
+    {
+        validate_compression_supported(file_name, "READ ERROR");
+        this->m_file.open(file_name, std::ios::in | std::ios::binary);
+        if (this->m_file.is_open() == false)
+        {
+            std::string error_message =
+                "READ ERROR - FAILED TO OPEN A FILE.\n"
+                "Please check " + file_name + " is correct.\n";
+            throw std::runtime_error(error_message);
+        }
+        this->m_worker = std::thread([this]()
+                                     { this->run_worker(); });
+    }
+
+    DECOMPRESS_STREAM(const DECOMPRESS_STREAM &) = delete;
+    DECOMPRESS_STREAM &operator=(const DECOMPRESS_STREAM &) = delete;
+
+    /**
+     * @brief Stops and joins the worker thread, the rest of the file is not decompressed.
+     *
+     */
+    ~DECOMPRESS_STREAM()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->m_queue_mutex);
+            this->m_is_stopped = true;
+        }
+        this->m_queue_cv.notify_all();
+        this->m_worker.join();
+    }
+
+    /**
+     * @brief
+     * Copies up to max_bytes decompressed bytes into output, waiting for the worker thread if needed.
+     * It throws the exception of the worker thread if decompression failed.
+     *
+     * @param[out] output The buffer the bytes are copied into.
+     * @param[in] max_bytes The size of the buffer.
+     * @return size_t The number of copied bytes, smaller than max_bytes only at the end of the file.
+     */
+    size_t read(char *output, const size_t max_bytes)
+    {
+        size_t num_read = 0;
+        while (num_read < max_bytes)
+        {
+            if (this->m_read_pos == this->m_read_chunk.size())
+            {
+                std::unique_lock<std::mutex> lock(this->m_queue_mutex);
+                this->m_queue_cv.wait(lock, [this]()
+                                      { return this->m_queue.empty() == false || this->m_is_finished; });
+                if (this->m_queue.empty() == true)
+                {
+                    if (this->m_error != nullptr)
+                    {
+                        std::rethrow_exception(this->m_error);
+                    }
+                    break;
+                }
+                this->m_read_chunk = std::move(this->m_queue.front());
+                this->m_queue.pop_front();
+                this->m_read_pos = 0;
+                lock.unlock();
+                this->m_queue_cv.notify_all();
+                continue;
+            }
+            size_t num_copied = std::min(max_bytes - num_read, this->m_read_chunk.size() - this->m_read_pos);
+            std::memcpy(output + num_read, this->m_read_chunk.data() + this->m_read_pos, num_copied);
+            this->m_read_pos += num_copied;
+            num_read += num_copied;
+        }
+        return num_read;
+    }
+
+private:
+    static constexpr size_t input_bytes = size_t(256) << 10;
+
+    std::string m_file_name;
+    COMPRESSION m_compression;
+    std::ifstream m_file;
+    std::thread m_worker;
+
+    std::deque<std::vector<char>> m_queue;
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_cv;
+    bool m_is_stopped = false;
+    bool m_is_finished = false;
+    std::exception_ptr m_error;
+
+    std::vector<char> m_read_chunk; // chunk being copied by read(), owned by the reading thread
+    size_t m_read_pos = 0;
+
+    /**
+     * @brief Main function of the worker thread, decompresses the file and marks the end of the stream.
+     *
+     */
+    void run_worker()
+    {
+        try
+        {
+            if (this->m_compression == COMPRESSION::GZIP)
+            {
+                this->decompress_gzip();
+            }
+            else
+            {
+                this->decompress_zstd();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(this->m_queue_mutex);
+            this->m_error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(this->m_queue_mutex);
+            this->m_is_finished = true;
+        }
+        this->m_queue_cv.notify_all();
+    }
+
+    /**
+     * @brief Queues a decompressed chunk, waiting while the queue is full.
+     *
+     * @param[in] chunk The decompressed chunk.
+     * @return true When the chunk is queued.
+     * @return false When the stream is being destroyed and the worker thread has to stop.
+     */
+    bool push_chunk(std::vector<char> &&chunk)
+    {
+        std::unique_lock<std::mutex> lock(this->m_queue_mutex);
+        this->m_queue_cv.wait(lock, [this]()
+                              { return this->m_is_stopped || this->m_queue.size() < max_queued_chunks; });
+        if (this->m_is_stopped == true)
+        {
+            return false;
+        }
+        this->m_queue.push_back(std::move(chunk));
+        lock.unlock();
+        this->m_queue_cv.notify_all();
+        return true;
+    }
+
+    /**
+     * @brief Reads the next compressed bytes of the file.
+     *
+     * @param[out] input The buffer the bytes are read into.
+     * @return size_t The number of bytes read, zero at the end of the file.
+     */
+    size_t read_input(std::vector<char> &input)
+    {
+        this->m_file.read(input.data(), static_cast<std::streamsize>(input.size()));
+        return static_cast<size_t>(this->m_file.gcount());
+    }
+
+    /**
+     * @brief Throws a runtime exception for a file that cannot be decompressed.
+     *
+     * @param[in] reason The reason decompression failed.
+     */
+    [[noreturn]] void throw_decompress_error(const std::string &reason) const
+    {
+        std::string error_message =
+            "READ ERROR - FAILED TO DECOMPRESS A FILE.\n"
+            "Cannot decompress " + this->m_file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+
+    /**
+     * @brief Decompresses gzip members of the file into the queue.
+     *
+     */
+    void decompress_gzip()
+    {
+#if defined(PROJ_USE_ZLIB)
+        struct INFLATE_STATE
+        {
+            z_stream stream{};
+            ~INFLATE_STATE() { inflateEnd(&stream); }
+        } inflate_state;
+        z_stream &stream = inflate_state.stream;
+        if (inflateInit2(&stream, 15 + 32) != Z_OK) // 15 + 32 - gzip or zlib header with the largest window
+        {
+            this->throw_decompress_error("Failed to initialize zlib.");
+        }
+
+        std::vector<char> input(input_bytes);
+        std::vector<char> chunk(chunk_bytes);
+        stream.next_out = reinterpret_cast<Bytef *>(chunk.data());
+        stream.avail_out = static_cast<uInt>(chunk.size());
+        bool is_member_end = false;
+        bool is_output_full = false;
+        while (true)
+        {
+            // when the output was full, the decompressor may hold more output without reading more input
+            if (stream.avail_in == 0 && is_output_full == false)
+            {
+                size_t num_input = this->read_input(input);
+                if (num_input == 0)
+                {
+                    break;
+                }
+                stream.next_in = reinterpret_cast<Bytef *>(input.data());
+                stream.avail_in = static_cast<uInt>(num_input);
+                if (is_member_end == true)
+                {
+                    inflateReset(&stream);
+                    is_member_end = false;
+                }
+            }
+
+            int inflate_result = inflate(&stream, Z_NO_FLUSH);
+            if (inflate_result == Z_STREAM_END)
+            {
+                is_member_end = true;
+                if (stream.avail_in > 0)
+                {
+                    inflateReset(&stream);
+                    is_member_end = false;
+                }
+            }
+            else if (inflate_result != Z_OK && inflate_result != Z_BUF_ERROR)
+            {
+                this->throw_decompress_error((stream.msg != nullptr) ? stream.msg : "The data is not valid gzip data.");
+            }
+
+            is_output_full = (stream.avail_out == 0);
+            if (is_output_full == true)
+            {
+                if (this->push_chunk(std::move(chunk)) == false)
+                {
+                    return;
+                }
+                chunk = std::vector<char>(chunk_bytes);
+                stream.next_out = reinterpret_cast<Bytef *>(chunk.data());
+                stream.avail_out = static_cast<uInt>(chunk.size());
+            }
+        }
+        if (is_member_end == false)
+        {
+            this->throw_decompress_error("The file ends in the middle of the compressed data.");
+        }
+        chunk.resize(chunk.size() - stream.avail_out);
+        if (chunk.empty() == false)
+        {
+            this->push_chunk(std::move(chunk));
+        }
+#else
+        this->throw_decompress_error("The program is built without zlib.");
+#endif
+    }
+
+    /**
+     * @brief Decompresses zstd frames of the file into the queue.
+     *
+     */
+    void decompress_zstd()
+    {
+#if defined(PROJ_USE_ZSTD)
+        struct ZSTD_STATE
+        {
+            ZSTD_DStream *stream = ZSTD_createDStream();
+            ~ZSTD_STATE() { ZSTD_freeDStream(stream); }
+        } zstd_state;
+        if (zstd_state.stream == nullptr || ZSTD_isError(ZSTD_initDStream(zstd_state.stream)))
+        {
+            this->throw_decompress_error("Failed to initialize zstd.");
+        }
+
+        std::vector<char> input(input_bytes);
+        std::vector<char> chunk(chunk_bytes);
+        ZSTD_inBuffer in_buffer{input.data(), 0, 0};
+        ZSTD_outBuffer out_buffer{chunk.data(), chunk.size(), 0};
+        size_t zstd_result = 0; // zero at the end of a frame
+        bool is_output_full = false;
+        while (true)
+        {
+            // when the output was full, the decompressor may hold more output without reading more input
+            if (in_buffer.pos == in_buffer.size && is_output_full == false)
+            {
+                size_t num_input = this->read_input(input);
+                if (num_input == 0)
+                {
+                    break;
+                }
+                in_buffer = ZSTD_inBuffer{input.data(), num_input, 0};
+            }
+
+            zstd_result = ZSTD_decompressStream(zstd_state.stream, &out_buffer, &in_buffer);
+            if (ZSTD_isError(zstd_result))
+            {
+                this->throw_decompress_error(ZSTD_getErrorName(zstd_result));
+            }
+
+            is_output_full = (out_buffer.pos == out_buffer.size);
+            if (is_output_full == true)
+            {
+                if (this->push_chunk(std::move(chunk)) == false)
+                {
+                    return;
+                }
+                chunk = std::vector<char>(chunk_bytes);
+                out_buffer = ZSTD_outBuffer{chunk.data(), chunk.size(), 0};
+            }
+        }
+        if (zstd_result != 0)
+        {
+            this->throw_decompress_error("The file ends in the middle of the compressed data.");
+        }
+        chunk.resize(out_buffer.pos);
+        if (chunk.empty() == false)
+        {
+            this->push_chunk(std::move(chunk));
+        }
+#else
+        this->throw_decompress_error("The program is built without zstd.");
+#endif
+    }
+};
+
+/**
+ * @class COMPRESS_STREAM
+ * @brief
+ * COMPRESS_STREAM class compresses bytes into .gz or .zst format and writes them to an opened file.
+ *
+ * @details
+ * gzip is written at the default level of zlib and zstd at level 3, the default of zstd tool.
+ * finish() must be called after the last write() to complete the compressed data.
+ */
+class COMPRESS_STREAM
+{
+public:
+    /**
+     * @brief Prepares compression of the format of file_name into output_file.
+     * It throws a runtime exception if the compression format is not supported.
+     *
+     * @param[in,out] output_file The opened file the compressed bytes are written to.
+     * @param[in] file_name Path to the file, .gz or .zst.
+     */
+    COMPRESS_STREAM(std::ofstream &output_file, const std::string &file_name)
+        : m_file(output_file), m_file_name(file_name), m_compression(get_compression(file_name)), m_output(output_bytes)
+    {
+        validate_compression_supported(file_name, "WRITE ERROR");
+#if defined(PROJ_USE_ZLIB)
+        if (this->m_compression == COMPRESSION::GZIP &&
+            deflateInit2(&this->m_gzip_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            this->throw_compress_error();
+        }
+#endif
+#if defined(PROJ_USE_ZSTD)
+        if (this->m_compression == COMPRESSION::ZSTD)
+        {
+            this->m_zstd_stream = ZSTD_createCStream();
+            if (this->m_zstd_stream == nullptr || ZSTD_isError(ZSTD_initCStream(this->m_zstd_stream, 3)))
+            {
+                this->throw_compress_error();
+            }
+        }
+#endif
+    }
+
+    COMPRESS_STREAM(const COMPRESS_STREAM &) = delete;
+    COMPRESS_STREAM &operator=(const COMPRESS_STREAM &) = delete;
+
+    /**
+     * @brief Releases the compressor.
+     *
+     */
+    ~COMPRESS_STREAM()
+    {
+#if defined(PROJ_USE_ZLIB)
+        if (this->m_compression == COMPRESSION::GZIP)
+        {
+            deflateEnd(&this->m_gzip_stream);
+        }
+#endif
+#if defined(PROJ_USE_ZSTD)
+        ZSTD_freeCStream(this->m_zstd_stream);
+#endif
+    }
+
+    /**
+     * @brief Compresses the bytes and writes the compressed bytes available so far.
+     *
+     * @param[in] input The bytes to be compressed.
+     * @param[in] num_bytes The number of bytes.
+     */
+    void write(const char *input, const size_t num_bytes)
+    {
+        this->compress(input, num_bytes, false);
+    }
+
+    /**
+     * @brief Completes the compressed data and writes the rest of it.
+     *
+     */
+    void finish()
+    {
+        this->compress(nullptr, 0, true);
+    }
+
+private:
+    static constexpr size_t output_bytes = size_t(256) << 10;
+
+    std::ofstream &m_file;
+    std::string m_file_name;
+    COMPRESSION m_compression;
+    std::vector<char> m_output;
+#if defined(PROJ_USE_ZLIB)
+    z_stream m_gzip_stream{};
+#endif
+#if defined(PROJ_USE_ZSTD)
+    ZSTD_CStream *m_zstd_stream = nullptr;
+#endif
+
+    /**
+     * @brief Feeds the bytes to the compressor and writes its output until the input is consumed.
+     *
+     * @param[in] input The bytes to be compressed.
+     * @param[in] num_bytes The number of bytes.
+     * @param[in] is_last Whether the compressed data is completed after the bytes.
+     */
+    void compress(const char *input, const size_t num_bytes, const bool is_last)
+    {
+#if defined(PROJ_USE_ZLIB)
+        if (this->m_compression == COMPRESSION::GZIP)
+        {
+            z_stream &stream = this->m_gzip_stream;
+            stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input));
+            stream.avail_in = static_cast<uInt>(num_bytes);
+            int deflate_result = Z_OK;
+            do
+            {
+                stream.next_out = reinterpret_cast<Bytef *>(this->m_output.data());
+                stream.avail_out = static_cast<uInt>(this->m_output.size());
+                deflate_result = deflate(&stream, is_last ? Z_FINISH : Z_NO_FLUSH);
+                if (deflate_result == Z_STREAM_ERROR)
+                {
+                    this->throw_compress_error();
+                }
+                this->m_file.write(this->m_output.data(), static_cast<std::streamsize>(this->m_output.size() - stream.avail_out));
+            } while (stream.avail_out == 0 || (is_last == true && deflate_result != Z_STREAM_END));
+            return;
+        }
+#endif
+#if defined(PROJ_USE_ZSTD)
+        if (this->m_compression == COMPRESSION::ZSTD)
+        {
+            ZSTD_inBuffer in_buffer{input, num_bytes, 0};
+            size_t zstd_result = 0; // bytes left in the compressor at the end
+            do
+            {
+                ZSTD_outBuffer out_buffer{this->m_output.data(), this->m_output.size(), 0};
+                zstd_result = ZSTD_compressStream2(this->m_zstd_stream, &out_buffer, &in_buffer, is_last ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(zstd_result))
+                {
+                    this->throw_compress_error();
+                }
+                this->m_file.write(this->m_output.data(), static_cast<std::streamsize>(out_buffer.pos));
+            } while (in_buffer.pos < in_buffer.size || (is_last == true && zstd_result != 0));
+            return;
+        }
+#endif
+        (void)input;
+        (void)num_bytes;
+        (void)is_last;
+    }
+
+    /**
+     * @brief Throws a runtime exception for a file that cannot be compressed.
+     *
+     */
+    [[noreturn]] void throw_compress_error() const
+    {
+        std::string error_message =
+            "WRITE ERROR - FAILED TO COMPRESS A FILE.\n"
+            "Cannot compress " + this->m_file_name + "\n";
+        throw std::runtime_error(error_message);
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "PCH.hpp"
+
+/**
+ * @brief
+ * CSV_COLUMN structure selects a column of a multi-column .csv file by its name in the header line or by its index.
+ *
+ */
+struct CSV_COLUMN
+{
+    std::string name; // name in the header line, used when it is not empty
+    size_t index = 0; // zero-based index of the column, used when the name is empty
+};
+
+/**
+ * @brief
+ * CSV_COLUMNS structure selects the two columns of a multi-column .csv file loaded as
+ * independent variables (X-Axis) and dependent variables (Y-Axis).
+ *
+ * @details
+ * The file consists of
+ * - comment lines starting with '%' (optional)
+ * - the count line holding the number of data points (optional)
+ * - the header line holding the comma-separated names of the columns (required if a column is selected by name)
+ * - data lines of comma-separated fields
+ * Only the selected fields are converted into numbers; the other fields are skipped and may hold any text,
+ * including quoted text with commas.
+ */
+struct CSV_COLUMNS
+{
+    CSV_COLUMN x_column{"", 0};
+    CSV_COLUMN y_column{"", 1};
+};
+
+/**
+ * @brief
+ * Converts a command-line word into CSV_COLUMN; a word of digits is a zero-based index, and any other word is a name.
+ *
+ * @param[in] column_word Name or index of the column.
+ * @return CSV_COLUMN
+ */
+inline CSV_COLUMN to_csv_column(const std::string &column_word)
+{
+    CSV_COLUMN csv_column;
+    bool is_index = (column_word.empty() == false) &&
+                    std::all_of(column_word.begin(), column_word.end(), [](char letter)
+                                { return letter >= '0' && letter <= '9'; });
+    if (is_index == true)
+    {
+        csv_column.index = std::stoul(column_word);
+    }
+    else
+    {
+        csv_column.name = column_word;
+    }
+    return csv_column;
+}
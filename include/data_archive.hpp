@@ -0,0 +1,265 @@
+/**
+ * The file contains the reader of .darc files, the archive format holding many series of data points.
+ */
+#pragma once
+#include "data_read.hpp"
+#include "archive_header.hpp"
+#include <string_view>
+
+/**
+ * @class DATA_ARCHIVE
+ * @brief
+ * DATA_ARCHIVE class reads the series of data points in .darc file written by DATA_WRITE::write_archive().
+ *
+ * @details
+ * The file is mapped into memory once, and its header, index and hash table are validated when it is opened.
+ * A series is found in O(1) time by its index or by its name, and
+ * it is returned as a DATA_SET object that refers to the columns in the mapping without parsing or copying.
+ * The mapping is kept until the DATA_ARCHIVE object and every DATA_SET object sharing the data are destroyed.
+ * Reading the series in order reads the file from the beginning to the end, so a batch over millions of series
+ * uses a single mapping instead of a file descriptor per series.
+ * It throws a runtime exception if the file is not a .darc file written on a machine of the same byte order,
+ * or a series refers to data outside the file.
+ * DATA_ARCHIVE class uses DATA_READ class with has-a relation for validation.
+ */
+class DATA_ARCHIVE
+{
+public:
+    /**
+     * @brief The index returned by find_series() when there is no series of the name.
+     *
+     */
+    static constexpr size_t npos = SIZE_MAX;
+
+    /**
+     * @brief
+     * Constructs a new DATA_ARCHIVE object and validates the header of the file.
+     * It throws an exception if the file does not exist, is not .darc format, or has an invalid header.
+     *
+     * @param[in] file_name Path to the file that will be read.
+     */
+    explicit DATA_ARCHIVE(const std::string &file_name) : m_file_name(file_name)
+    {
+        DATA_READ data_read;
+        data_read.validate_target_is_exist(file_name);
+        data_read.validate_target_is_file(file_name);
+        data_read.validate_target_format(file_name, ".darc");
+
+        this->m_mapped_file = std::make_shared<const MAPPED_FILE>(file_name);
+        std::string_view file_text = this->m_mapped_file->get_view();
+        if (file_text.size() < sizeof(ARCHIVE_HEADER))
+        {
+            throw_archive_error("The file is smaller than the header.");
+        }
+        std::memcpy(&this->m_header, file_text.data(), sizeof(ARCHIVE_HEADER));
+        validate_archive_header(file_text.size());
+
+        const char *file_data = file_text.data();
+        this->m_entries = reinterpret_cast<const ARCHIVE_ENTRY *>(file_data + this->m_header.entries_offset);
+        this->m_buckets = reinterpret_cast<const uint64_t *>(file_data + this->m_header.buckets_offset);
+        this->m_names = file_data + this->m_header.names_offset;
+        this->m_x_column = reinterpret_cast<const double *>(file_data + this->m_header.x_offset);
+        this->m_y_column = reinterpret_cast<const double *>(file_data + this->m_header.y_offset);
+    }
+
+    /**
+     * @brief Gets the number of series in the archive.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return static_cast<size_t>(this->m_header.num_series);
+    }
+
+    /**
+     * @brief Gets the total number of data points of every series in the archive.
+     *
+     * @return size_t
+     */
+    size_t get_num_data_points() const
+    {
+        return static_cast<size_t>(this->m_header.num_data_points);
+    }
+
+    /**
+     * @brief Gets the name of a series.
+     *
+     * @param[in] series_index The index of the series, smaller than size().
+     * @return std::string_view The name, valid while the DATA_ARCHIVE object exists.
+     */
+    std::string_view get_name(const size_t series_index) const
+    {
+        const ARCHIVE_ENTRY &archive_entry = this->get_entry(series_index);
+        return std::string_view(this->m_names + archive_entry.name_offset, archive_entry.name_bytes);
+    }
+
+    /**
+     * @brief Gets the data points of a series in O(1) time without copying them.
+     *
+     * @param[in] series_index The index of the series, smaller than size().
+     * @return DATA_SET The data points that keep the mapping of the archive alive.
+     */
+    DATA_SET get_series(const size_t series_index) const
+    {
+        const ARCHIVE_ENTRY &archive_entry = this->get_entry(series_index);
+        size_t num_points = static_cast<size_t>(archive_entry.num_points);
+        std::span<const double> x_series(this->m_x_column + archive_entry.first_point, num_points);
+        std::span<const double> y_series(this->m_y_column + archive_entry.first_point, num_points);
+        return DATA_SET(this->m_mapped_file, x_series, y_series);
+    }
+
+    /**
+     * @brief
+     * Gets the data points of the series of the given name in O(1) time without copying them.
+     * It throws a runtime exception if there is no series of the name.
+     *
+     * @param[in] series_name The name of the series.
+     * @return DATA_SET The data points that keep the mapping of the archive alive.
+     */
+    DATA_SET get_series(const std::string_view series_name) const
+    {
+        size_t series_index = this->find_series(series_name);
+        if (series_index == npos)
+        {
+            std::string error_message =
+                "READ ERROR - SERIES IS NOT FOUND.\n"
+                "There is no series " + std::string(series_name) + " in " + this->m_file_name + "\n";
+            throw std::runtime_error(error_message);
+        }
+        return this->get_series(series_index);
+    }
+
+    /**
+     * @brief Finds the index of the series of the given name through the hash table of the archive.
+     *
+     * @param[in] series_name The name of the series.
+     * @return size_t The index of the series, or npos if there is no series of the name.
+     */
+    size_t find_series(const std::string_view series_name) const
+    {
+        const uint64_t bucket_mask = this->m_header.num_buckets - 1;
+        uint64_t bucket_index = get_archive_hash(series_name) & bucket_mask;
+        for (uint64_t num_probes = 0; num_probes < this->m_header.num_buckets; num_probes++)
+        {
+            uint64_t bucket_value = this->m_buckets[bucket_index];
+            if (bucket_value == 0)
+            {
+                return npos;
+            }
+            if (bucket_value > this->m_header.num_series)
+            {
+                throw_archive_error("A bucket of the hash table refers to series " + std::to_string(bucket_value) + ".");
+            }
+            size_t series_index = static_cast<size_t>(bucket_value - 1);
+            if (this->get_name(series_index) == series_name)
+            {
+                return series_index;
+            }
+            bucket_index = (bucket_index + 1) & bucket_mask;
+        }
+        return npos;
+    }
+
+private:
+    std::string m_file_name;
+    std::shared_ptr<const MAPPED_FILE> m_mapped_file;
+    ARCHIVE_HEADER m_header;
+    const ARCHIVE_ENTRY *m_entries = nullptr;
+    const uint64_t *m_buckets = nullptr;
+    const char *m_names = nullptr;
+    const double *m_x_column = nullptr;
+    const double *m_y_column = nullptr;
+
+    /**
+     * @brief
+     * Gets the entry of a series in the index and validates that its name and data points lie inside the file.
+     * It throws a runtime exception if the index is out of range or the entry is invalid.
+     *
+     * @param[in] series_index The index of the series.
+     * @return const ARCHIVE_ENTRY&
+     */
+    const ARCHIVE_ENTRY &get_entry(const size_t series_index) const
+    {
+        if (series_index >= this->m_header.num_series)
+        {
+            std::string error_message =
+                "READ ERROR - SERIES IS NOT FOUND.\n"
+                "Series " + std::to_string(series_index + 1) + " is requested, but " + this->m_file_name +
+                " holds " + std::to_string(this->m_header.num_series) + " series.\n";
+            throw std::out_of_range(error_message);
+        }
+        const ARCHIVE_ENTRY &archive_entry = this->m_entries[series_index];
+        bool is_inside = archive_entry.name_offset <= this->m_header.names_bytes &&
+                         archive_entry.name_bytes <= this->m_header.names_bytes - archive_entry.name_offset &&
+                         archive_entry.first_point <= this->m_header.num_data_points &&
+                         archive_entry.num_points <= this->m_header.num_data_points - archive_entry.first_point;
+        if (is_inside == false)
+        {
+            throw_archive_error("Series " + std::to_string(series_index + 1) + " exceeds the names or the columns.");
+        }
+        return archive_entry;
+    }
+
+    /**
+     * @brief
+     * The function validates the header of .darc file and throws a runtime exception if
+     * the index, the hash table, the names or the columns cannot be used on this machine.
+     *
+     * @param[in] file_size The size of the file in bytes.
+     */
+    void validate_archive_header(const uint64_t file_size) const
+    {
+        const ARCHIVE_HEADER expected_header;
+        const ARCHIVE_HEADER &archive_header = this->m_header;
+        if (std::memcmp(archive_header.magic, expected_header.magic, sizeof(expected_header.magic)) != 0)
+        {
+            throw_archive_error("The file does not start with the .darc magic number.");
+        }
+        if (archive_header.endian_tag != expected_header.endian_tag)
+        {
+            throw_archive_error("The file is written on a machine of the other byte order.");
+        }
+        if (archive_header.version != expected_header.version)
+        {
+            throw_archive_error("Version " + std::to_string(archive_header.version) + " is not supported.");
+        }
+        if (archive_header.dtype != static_cast<uint32_t>(DBIN_DTYPE::FLOAT64))
+        {
+            throw_archive_error("Data type " + std::to_string(archive_header.dtype) + " is not supported.");
+        }
+        if (archive_header.num_buckets == 0 || (archive_header.num_buckets & (archive_header.num_buckets - 1)) != 0 ||
+            archive_header.num_buckets <= archive_header.num_series)
+        {
+            throw_archive_error("The hash table of " + std::to_string(archive_header.num_buckets) + " buckets is invalid.");
+        }
+
+        auto is_region_inside = [file_size](uint64_t region_offset, uint64_t num_elements, uint64_t element_bytes)
+        {
+            return region_offset % element_bytes == 0 && region_offset <= file_size &&
+                   num_elements <= (file_size - region_offset) / element_bytes;
+        };
+        bool is_inside = is_region_inside(archive_header.entries_offset, archive_header.num_series, sizeof(ARCHIVE_ENTRY)) &&
+                         is_region_inside(archive_header.buckets_offset, archive_header.num_buckets, sizeof(uint64_t)) &&
+                         is_region_inside(archive_header.names_offset, archive_header.names_bytes, 1) &&
+                         is_region_inside(archive_header.x_offset, archive_header.num_data_points, sizeof(double)) &&
+                         is_region_inside(archive_header.y_offset, archive_header.num_data_points, sizeof(double));
+        if (is_inside == false)
+        {
+            throw_archive_error("The index, the names or the columns are not aligned or exceed the end of the file.");
+        }
+    }
+
+    /**
+     * @brief The function throws a runtime exception for an invalid .darc file.
+     *
+     * @param[in] reason The reason the file is invalid.
+     */
+    [[noreturn]] void throw_archive_error(const std::string &reason) const
+    {
+        std::string error_message =
+            "READ ERROR - INVALID ARCHIVE FILE.\n"
+            "Cannot load " + this->m_file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+};
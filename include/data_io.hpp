@@ -1,6 +1,10 @@
 #pragma once
 #include "data_read.hpp"
 #include "data_write.hpp"
+#include "data_stream.hpp"
+#include "data_set.hpp"
+#include "async_file_reader.hpp"
+#include <optional>
 
 /**
  * @brief
@@ -9,7 +13,9 @@
 enum class IO_MODE
 {
     UNSAFE,
-    SAFE
+    SAFE,
+    MAPPED,
+    PARALLEL
 };
 
 /**
@@ -18,7 +24,7 @@ enum class IO_MODE
  * DATA_IO class is a collection of data read/write functions used in the project.
  * The class is written for convenience purposes that read, and therefore,
  * the read/write methods can be accessed directly without using DATA_IO class.
- * However, it automatically chooses the type of method (SAFE/UNSAFE),
+ * However, it automatically chooses the type of method (SAFE/UNSAFE/MAPPED/PARALLEL),
  * the use of DATA_IO class is preferred to safety.
  * DATA_IO class does not contain a validation process as
  * validation processes will be done in DATA_READ and DATA_WRITE classes.
@@ -30,7 +36,7 @@ public:
     /**
      * @brief Construct a new data io object
      *
-     * @param io_method defines that the data load/write will be done in SAFE/UNSAFE mode.
+     * @param io_method defines that the data load/write will be done in SAFE/UNSAFE/MAPPED/PARALLEL mode.
      */
     DATA_IO(IO_MODE io_method) : m_io_method(io_method)
     {
@@ -47,20 +53,34 @@ public:
      * @param[in] file_name name of file to be loaded
      * @param[out] output_vec_one a collection of independent variables (X-Axis values)
      * @param[out] output_vec_two - a collection of dependent variables (Y-Axis values)
+     * @param[out] data_stats statistics of the loaded data points, accumulated while parsing in MAPPED/PARALLEL mode;
+     * it is left unchanged by the other methods and is not computed if it is null
      * @return true
      * @return false
      */
-    bool load_vec(const std::string file_name, std::vector<double> &output_vec_one, std::vector<double> &output_vec_two)
+    bool load_vec(const std::string file_name, std::vector<double> &output_vec_one, std::vector<double> &output_vec_two,
+                  DATA_STATS *data_stats = nullptr)
     {
+        if (get_compression(file_name) != COMPRESSION::NONE)
+        {
+            return this->load_compressed(file_name, output_vec_one, output_vec_two);
+        }
         bool load_result = true;
         switch (m_io_method)
         {
         case IO_MODE::SAFE:
-            // load_result = r_vec.load_vec_SAFE(file_name, output_vec_one, output_vec_two);
+            load_result = r_vec.load_vec_SAFE(file_name, output_vec_one, output_vec_two);
             break;
         case IO_MODE::UNSAFE:
             load_result = r_vec.load_vec_UNSAFE(file_name, output_vec_one, output_vec_two);
             break;
+        case IO_MODE::MAPPED:
+            load_result = r_vec.load_vec_MAPPED(file_name, output_vec_one, output_vec_two, data_stats);
+            break;
+        case IO_MODE::PARALLEL:
+            load_result = r_vec.load_vec_PARALLEL(file_name, output_vec_one, output_vec_two, get_thread_pool(), m_chunk_bytes,
+                                                      data_stats);
+            break;
         }
         return load_result;
     }
@@ -70,25 +90,168 @@ public:
      * The function loads .csv format file and returns two vectors containing
      * - a collection of independent variables (X-Axis values)
      * - a collection of dependent variables (Y-Axis values)
+     * If the columns are set by set_csv_columns(), the two columns are loaded from a multi-column file
+     * regardless of the io method.
      *
      * @param[in] file_name name of file to be loaded
      * @param[out] output_vec_one a collection of independent variables (X-Axis values)
      * @param[out] output_vec_two - a collection of dependent variables (Y-Axis values)
+     * @param[out] data_stats statistics of the loaded data points, accumulated while parsing in MAPPED/PARALLEL mode;
+     * it is left unchanged by the other methods and is not computed if it is null
      * @return true
      * @return false
      */
-    bool load_csv(const std::string file_name, std::vector<double> &output_vec_one, std::vector<double> &output_vec_two)
+    bool load_csv(const std::string file_name, std::vector<double> &output_vec_one, std::vector<double> &output_vec_two,
+                  DATA_STATS *data_stats = nullptr)
     {
+        if (m_csv_columns.has_value() == true)
+        {
+            return r_vec.load_csv_COLUMNS(file_name, output_vec_one, output_vec_two, m_csv_columns.value());
+        }
+        if (get_compression(file_name) != COMPRESSION::NONE)
+        {
+            return this->load_compressed(file_name, output_vec_one, output_vec_two);
+        }
         bool load_result = true;
         switch (m_io_method)
         {
         case IO_MODE::SAFE:
-            // load_result = r_vec.load_csv_SAFE(file_name, output_vec_one, output_vec_two);
+            load_result = r_vec.load_csv_SAFE(file_name, output_vec_one, output_vec_two);
             break;
         case IO_MODE::UNSAFE:
             load_result = r_vec.load_csv_UNSAFE(file_name, output_vec_one, output_vec_two);
             break;
+        case IO_MODE::MAPPED:
+            load_result = r_vec.load_csv_MAPPED(file_name, output_vec_one, output_vec_two, data_stats);
+            break;
+        case IO_MODE::PARALLEL:
+            load_result = r_vec.load_csv_PARALLEL(file_name, output_vec_one, output_vec_two, get_thread_pool(), m_chunk_bytes,
+                                                      data_stats);
+            break;
+        }
+        return load_result;
+    }
+
+    /**
+     * @brief
+     * The function loads .dvec format file into a DATA_SET object.
+     * The loaded vectors are moved into the DATA_SET object without copying them.
+     * In MAPPED/PARALLEL mode, the statistics accumulated while parsing are attached to the DATA_SET object,
+     * so the regression and the plot do not scan the data points again.
+     *
+     * @param[in] file_name name of file to be loaded
+     * @param[out] observed_data a collection of loaded data points
+     * @return true
+     * @return false
+     */
+    bool load_vec(const std::string file_name, DATA_SET &observed_data)
+    {
+        std::vector<double> x_observed;
+        std::vector<double> y_observed;
+        DATA_STATS data_stats;
+        bool load_result = this->load_vec(file_name, x_observed, y_observed, &data_stats);
+        std::shared_ptr<const BLOCK_STATS> block_stats = this->get_parse_stats(data_stats, x_observed.size());
+        observed_data = DATA_SET(std::move(x_observed), std::move(y_observed), std::move(block_stats));
+        return load_result;
+    }
+
+    /**
+     * @brief
+     * The function loads .csv format file into a DATA_SET object.
+     * The loaded vectors are moved into the DATA_SET object without copying them.
+     * In MAPPED/PARALLEL mode, the statistics accumulated while parsing are attached to the DATA_SET object,
+     * so the regression and the plot do not scan the data points again.
+     *
+     * @param[in] file_name name of file to be loaded
+     * @param[out] observed_data a collection of loaded data points
+     * @return true
+     * @return false
+     */
+    bool load_csv(const std::string file_name, DATA_SET &observed_data)
+    {
+        std::vector<double> x_observed;
+        std::vector<double> y_observed;
+        DATA_STATS data_stats;
+        bool load_result = this->load_csv(file_name, x_observed, y_observed, &data_stats);
+        std::shared_ptr<const BLOCK_STATS> block_stats = this->get_parse_stats(data_stats, x_observed.size());
+        observed_data = DATA_SET(std::move(x_observed), std::move(y_observed), std::move(block_stats));
+        return load_result;
+    }
+
+    /**
+     * @brief
+     * The function loads .dbin format file into a DATA_SET object.
+     * The file is mapped into memory and the data is used in place without parsing or copying it,
+     * regardless of the io method; IO_MODE::SAFE additionally checks that every value is a finite number.
+     *
+     * @param[in] file_name name of file to be loaded
+     * @param[out] observed_data a collection of loaded data points
+     * @return true
+     * @return false
+     */
+    bool load_dbin(const std::string file_name, DATA_SET &observed_data)
+    {
+        if (m_io_method == IO_MODE::SAFE)
+        {
+            return r_vec.load_dbin_SAFE(file_name, observed_data);
+        }
+        return r_vec.load_dbin(file_name, observed_data);
+    }
+
+    /**
+     * @brief
+     * The function loads .dvec, .csv or .dbin format file into a DATA_SET object
+     * with the method chosen by the extension of the file name.
+     * A file name without .csv or .dbin extension is loaded as .dvec format.
+     * .gz or .zst extension after .dvec or .csv, e.g. observed_data.dvec.gz, denotes a compressed file.
+     * standard_stream_name ("-") loads the standard input in the format set by set_stream_format().
+     *
+     * @param[in] file_name name of file to be loaded
+     * @param[out] observed_data a collection of loaded data points
+     * @return true
+     * @return false
+     */
+    bool load_data(const std::string file_name, DATA_SET &observed_data)
+    {
+        std::filesystem::path file_extension = this->get_data_extension(file_name);
+        if (file_extension == ".dbin")
+        {
+            return this->load_dbin(file_name, observed_data);
         }
+        if (file_extension == ".csv")
+        {
+            return this->load_csv(file_name, observed_data);
+        }
+        return this->load_vec(file_name, observed_data);
+    }
+
+    /**
+     * @brief
+     * The function loads the content of .dvec, .csv or .dbin format file that has been read into memory
+     * by ASYNC_FILE_READER into a DATA_SET object, with the format chosen by the extension of the file name.
+     * .dvec and .csv files are parsed on the calling thread as IO_MODE::MAPPED does, with the statistics attached;
+     * .dbin file is used in place, and the DATA_SET object keeps the buffer alive.
+     * It is meant for uncompressed two-column files loaded without validation, e.g. Batch Mode without --safe.
+     *
+     * @param[in] file_name name of the file read into the buffer
+     * @param[in] file_buffer the whole content of the file
+     * @param[out] observed_data a collection of loaded data points
+     * @return true
+     * @return false
+     */
+    bool load_data(const std::string file_name, std::shared_ptr<const FILE_BUFFER> file_buffer, DATA_SET &observed_data)
+    {
+        std::string_view file_text = file_buffer->get_view();
+        if (this->get_data_extension(file_name) == ".dbin")
+        {
+            return r_vec.load_dbin(file_name, std::move(file_buffer), file_text, observed_data);
+        }
+        std::vector<double> x_observed;
+        std::vector<double> y_observed;
+        DATA_STATS data_stats;
+        bool load_result = r_vec.load_text(file_name, file_text, x_observed, y_observed, &data_stats);
+        std::shared_ptr<const BLOCK_STATS> block_stats = this->get_parse_stats(data_stats, x_observed.size());
+        observed_data = DATA_SET(std::move(x_observed), std::move(y_observed), std::move(block_stats));
         return load_result;
     }
 
@@ -104,9 +267,10 @@ public:
      * @return true
      * @return false
      */
-    bool write_vec(const std::string file_name, const std::vector<double> &output_vec_one, const std::vector<double> &output_vec_two)
+    bool write_vec(const std::string file_name, std::span<const double> output_vec_one, std::span<const double> output_vec_two)
     {
-        w_vec.write_vec(file_name, output_vec_one, output_vec_two);
+        w_vec.write_vec(file_name, output_vec_one, output_vec_two,
+                      (m_io_method == IO_MODE::PARALLEL) ? &get_thread_pool() : nullptr);
         return true;
     }
 
@@ -122,12 +286,168 @@ public:
      * @return true
      * @return false
      */
-    bool write_csv(const std::string file_name, const std::vector<double> &output_vec_one, const std::vector<double> &output_vec_two)
+    bool write_csv(const std::string file_name, std::span<const double> output_vec_one, std::span<const double> output_vec_two)
     {
-        w_vec.write_csv(file_name, output_vec_one, output_vec_two);
+        w_vec.write_csv(file_name, output_vec_one, output_vec_two,
+                      (m_io_method == IO_MODE::PARALLEL) ? &get_thread_pool() : nullptr);
         return true;
     }
 
+    /**
+     * @brief
+     * The function writes .dbin format file based on given two vectors containing
+     * - a collection of independent variables (X-Axis values)
+     * - a collection of dependent variables (Y-Axis values)
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] output_vec_one a collection of independent variables (X-Axis values)
+     * @param[in] output_vec_two a collection of dependent variables (Y-Axis values)
+     * @return true
+     * @return false
+     */
+    bool write_dbin(const std::string file_name, std::span<const double> output_vec_one, std::span<const double> output_vec_two)
+    {
+        w_vec.write_dbin(file_name, output_vec_one, output_vec_two);
+        return true;
+    }
+
+    /**
+     * @brief The function writes .dbin format file based on the given DATA_SET object.
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] output_data a collection of data points to be written
+     * @return true
+     * @return false
+     */
+    bool write_dbin(const std::string file_name, const DATA_SET &output_data)
+    {
+        return this->write_dbin(file_name, output_data.get_x(), output_data.get_y());
+    }
+
+    /**
+     * @brief
+     * The function writes .dvec, .csv or .dbin format file based on the given DATA_SET object
+     * with the method chosen by the extension of the file name.
+     * A file name without .csv or .dbin extension is written as .dvec format, which requires .dvec extension.
+     * .gz or .zst extension after .dvec or .csv, e.g. outlier_data.dvec.gz, compresses the file.
+     * standard_stream_name ("-") writes to the standard output in the format set by set_stream_format().
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] output_data a collection of data points to be written
+     * @return true
+     * @return false
+     */
+    bool write_data(const std::string file_name, const DATA_SET &output_data)
+    {
+        std::filesystem::path file_extension = this->get_data_extension(file_name);
+        if (file_extension == ".dbin")
+        {
+            return this->write_dbin(file_name, output_data);
+        }
+        if (file_extension == ".csv")
+        {
+            return this->write_csv(file_name, output_data);
+        }
+        return this->write_vec(file_name, output_data);
+    }
+
+    /**
+     * @brief
+     * The function writes .darc format file holding the given series of data points in the given order,
+     * which is read with DATA_ARCHIVE class.
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] series_names the unique name of each series
+     * @param[in] series_data the data points of each series
+     * @return true
+     * @return false
+     */
+    bool write_archive(const std::string file_name, std::span<const std::string> series_names, std::span<const DATA_SET> series_data)
+    {
+        w_vec.write_archive(file_name, series_names, series_data);
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function converts a data file into the format of output_file_name, e.g. .dvec or .csv into .dbin.
+     *
+     * @param[in] input_file_name name of file to be loaded, .dvec, .csv or .dbin
+     * @param[in] output_file_name name of file to be written, .dvec, .csv or .dbin
+     * @return true
+     * @return false
+     */
+    bool convert_data(const std::string input_file_name, const std::string output_file_name)
+    {
+        DATA_SET observed_data;
+        this->load_data(input_file_name, observed_data);
+        return this->write_data(output_file_name, observed_data);
+    }
+
+    /**
+     * @brief The function writes .dvec format file based on the given DATA_SET object.
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] output_data a collection of data points to be written
+     * @return true
+     * @return false
+     */
+    bool write_vec(const std::string file_name, const DATA_SET &output_data)
+    {
+        return this->write_vec(file_name, output_data.get_x(), output_data.get_y());
+    }
+
+    /**
+     * @brief The function writes .csv format file based on the given DATA_SET object.
+     *
+     * @param[in] file_name name of file to be written
+     * @param[in] output_data a collection of data points to be written
+     * @return true
+     * @return false
+     */
+    bool write_csv(const std::string file_name, const DATA_SET &output_data)
+    {
+        return this->write_csv(file_name, output_data.get_x(), output_data.get_y());
+    }
+
+    /**
+     * @brief
+     * Sets the thread pool used by IO_MODE::PARALLEL, which can be shared with other objects.
+     * If it is not used, a thread pool of the number of hardware threads is created by the first parallel load.
+     *
+     * @param[in] thread_pool Threads used for parsing.
+     * @param[in] chunk_bytes The number of bytes parsed by a task, zero means the default size.
+     */
+    void set_parallel(std::shared_ptr<THREAD_POOL> thread_pool, const size_t chunk_bytes = 0)
+    {
+        this->m_thread_pool = std::move(thread_pool);
+        this->m_chunk_bytes = chunk_bytes;
+    }
+
+    /**
+     * @brief
+     * Sets the columns of .csv files loaded as X-Axis and Y-Axis, selected by name or by index.
+     * The other columns are skipped without being parsed. See CSV_COLUMNS for the layout of the file.
+     *
+     * @param[in] csv_columns The columns loaded as X-Axis and Y-Axis.
+     */
+    void set_csv_columns(const CSV_COLUMNS &csv_columns)
+    {
+        this->m_csv_columns = csv_columns;
+    }
+
+    /**
+     * @brief
+     * Sets the format of the standard input and the standard output, which are read and written by
+     * load_data() and write_data() with standard_stream_name ("-"); .dvec by default.
+     *
+     * @param[in] stream_format The extension of the format, .dvec, .csv or .dbin.
+     */
+    void set_stream_format(const std::string &stream_format)
+    {
+        this->m_stream_format = stream_format;
+    }
+
     /**
      * @brief Get the io method object
      *
@@ -154,6 +474,103 @@ private:
     IO_MODE m_io_method;
     DATA_READ r_vec;
     DATA_WRITE w_vec;
+    std::shared_ptr<THREAD_POOL> m_thread_pool;
+    size_t m_chunk_bytes = 0;
+    std::optional<CSV_COLUMNS> m_csv_columns; // two-column .csv files are loaded if it is not set
+    std::string m_stream_format = ".dvec";     // format of the standard input and output
+
+    /**
+     * @brief Gets the extension that chooses the format of the file, without .gz or .zst extension.
+     *
+     * @param[in] file_name name of file, or standard_stream_name for the standard input and output
+     * @return std::filesystem::path
+     */
+    std::filesystem::path get_data_extension(const std::string &file_name) const
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            return this->m_stream_format;
+        }
+        return remove_compression_extension(file_name).extension();
+    }
+
+    /**
+     * @brief
+     * The function loads .dvec or .csv file compressed with gzip or zstd.
+     * The file is decompressed on another thread while the decompressed text is parsed by DATA_STREAM.
+     * With IO_MODE::SAFE, the whole decompressed text is kept in memory and validated as load_vec_SAFE() does,
+     * reporting the line and the column of the first error.
+     *
+     * @param[in] file_name name of file to be loaded, e.g. observed_data.dvec.gz
+     * @param[out] output_vec_one a collection of independent variables (X-Axis values)
+     * @param[out] output_vec_two a collection of dependent variables (Y-Axis values)
+     * @return true
+     */
+    bool load_compressed(const std::string &file_name, std::vector<double> &output_vec_one, std::vector<double> &output_vec_two)
+    {
+        if (m_io_method == IO_MODE::SAFE)
+        {
+            std::string file_text;
+            DECOMPRESS_STREAM decompress_stream(file_name);
+            size_t num_read = 0;
+            do
+            {
+                file_text.resize(num_read + DECOMPRESS_STREAM::chunk_bytes);
+                num_read += decompress_stream.read(file_text.data() + num_read, DECOMPRESS_STREAM::chunk_bytes);
+            } while (num_read == file_text.size());
+            file_text.resize(num_read);
+            char delimiter = (this->get_data_extension(file_name) == ".csv") ? ',' : ' ';
+            return r_vec.load_text_SAFE(file_name, file_text, output_vec_one, output_vec_two, delimiter);
+        }
+        DATA_STREAM data_stream(file_name);
+        output_vec_one.clear();
+        output_vec_two.clear();
+        if (data_stream.get_num_data_points() != DATA_STREAM::unknown_num_data_points)
+        {
+            output_vec_one.reserve(data_stream.get_num_data_points());
+            output_vec_two.reserve(data_stream.get_num_data_points());
+        } // otherwise, the vectors grow geometrically as the blocks are appended
+        for (const DATA_BLOCK &data_block : data_stream)
+        {
+            output_vec_one.insert(output_vec_one.end(), data_block.x_block.begin(), data_block.x_block.end());
+            output_vec_two.insert(output_vec_two.end(), data_block.y_block.begin(), data_block.y_block.end());
+        }
+        return true;
+    }
+
+    /**
+     * @brief
+     * Gets the statistics accumulated while parsing as the statistics of the whole data without blocks,
+     * or null if the load method did not accumulate the statistics of every loaded data point.
+     *
+     * @param[in] data_stats statistics accumulated by the load method
+     * @param[in] num_data_points the number of loaded data points
+     * @return std::shared_ptr<const BLOCK_STATS>
+     */
+    std::shared_ptr<const BLOCK_STATS> get_parse_stats(const DATA_STATS &data_stats, const size_t num_data_points) const
+    {
+        if (num_data_points == 0 || data_stats.num_points != num_data_points)
+        {
+            return nullptr;
+        }
+        auto block_stats = std::make_shared<BLOCK_STATS>();
+        block_stats->total = data_stats;
+        return block_stats;
+    }
+
+    /**
+     * @brief Gets the thread pool used by IO_MODE::PARALLEL, creating it if it is not set.
+     *
+     * @return THREAD_POOL&
+     */
+    THREAD_POOL &get_thread_pool()
+    {
+        if (this->m_thread_pool == nullptr)
+        {
+            this->m_thread_pool = std::make_shared<THREAD_POOL>();
+        }
+        return *this->m_thread_pool;
+    }
 
     /**
      * @brief The print current IO mode of the object.
@@ -170,6 +587,14 @@ private:
         case IO_MODE::UNSAFE:
             std::cout << "UNSAFE" << std::endl;
             break;
+
+        case IO_MODE::MAPPED:
+            std::cout << "MAPPED" << std::endl;
+            break;
+
+        case IO_MODE::PARALLEL:
+            std::cout << "PARALLEL" << std::endl;
+            break;
         }
     }
 };
\ No newline at end of file
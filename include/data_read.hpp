@@ -1,5 +1,14 @@
 #pragma once
 #include "PCH.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+#include "data_set.hpp"
+#include "dbin_header.hpp"
+#include "csv_columns.hpp"
+#include "compressed_file.hpp"
+#include <charconv>
+#include <cstring>
+#include <sstream>
 
 /**
  * @class READ_DATA
@@ -8,17 +17,41 @@
  *  READ_DATA class supports the following data formats.
  *  .dvec - custom data format for the project, preferred when the use of a spreadsheet is not expected
  *  .csv - comma-separated variables format for users who wants to load data from Excel, Matlab, or other spreadsheet-based data formats.
+ *  .dbin - binary data format for the project, loaded by mapping the file without parsing or copying
  *
  * UNSAFE or SAFE
  *  The keyword UNSAFE and SAFE distinguish that the loading method checks loaded data is following the required data format.
  *  For example, load method with
  *  - SAFE keyword will check that there are two data in each line of loaded file, and each data is number while
  *  - UNSAFE keyword will load data without validation.
+ *  SAFE method maps the file and validates it while parsing it with std::from_chars in a single pass, and
+ *  reports the line and the column of the first error.
+ *  It is faster than UNSAFE method because UNSAFE method reads the file through std::ifstream;
+ *  the validation itself costs little on top of MAPPED method.
  *  SAFE method is preferred when the input data is generated manually - i.e.) entire data is typed by hand.
- *  UNSAFE method is preferred when the input data is generated by software - i.e.) entire data is generated by Matlab
+ *  For data generated by software - i.e.) entire data is generated by Matlab - MAPPED method below is preferred;
+ *  it skips the validation as UNSAFE method does, without the cost of std::ifstream.
+ *
+ * MAPPED
+ *  The keyword MAPPED denotes that the loading method maps the file into memory and
+ *  parses the numbers with std::from_chars instead of std::ifstream.
+ *  It is much faster than UNSAFE method on large files, and it does not depend on the locale.
+ *  It checks only that every expected number can be parsed.
+ *
+ * PARALLEL
+ *  The keyword PARALLEL denotes MAPPED method that splits the file into chunks at line breaks and
+ *  parses the chunks concurrently on a thread pool. Each line must hold a single data point.
+ *
+ * COUNT LINE
+ *  Every method accepts files without the count line; a file is count-prefixed when its first line after the comments
+ *  holds only a non-negative integer. Otherwise, the data points are read until the end of the file into vectors
+ *  reserved once from the size of the file.
  */
 class DATA_READ
 {
+    friend class DATA_STREAM; // reads files block by block with the parsing and validation functions
+    friend class DATA_ARCHIVE; // reads .darc files with the validation functions
+
 public:
     DATA_READ() {}
     virtual ~DATA_READ() {}
@@ -41,6 +74,10 @@ public:
         validate_target_is_exist(file_name);
         validate_target_is_file(file_name);
         validate_target_format(file_name, ".dvec");
+        if (is_standard_stream(file_name) == true)
+        {
+            return load_mapped(file_name, vec_one, vec_two); // the standard input cannot be opened with std::ifstream
+        }
 
         std::ifstream load_vec;
         load_vec.open(file_name, std::ios::in);
@@ -52,18 +89,43 @@ public:
             std::getline(load_vec, read_line);
         }
 
-        uint32_t vec_len = 0;
-        load_vec >> vec_len;
-
         double temp_val_one;
         double temp_val_two;
-        vec_one = std::vector<double>(vec_len, 0);
-        vec_two = std::vector<double>(vec_len, 0);
-        for (uint32_t iter = 0; iter < vec_len; iter++)
+        std::string first_line;
+        load_vec >> std::ws;
+        std::getline(load_vec, first_line);
+        std::istringstream first_stream(first_line);
+        if (is_count_line(first_line.data(), first_line.data() + first_line.size()) == true)
+        {
+            uint32_t vec_len = 0;
+            first_stream >> vec_len;
+            vec_one = std::vector<double>(vec_len, 0);
+            vec_two = std::vector<double>(vec_len, 0);
+            for (uint32_t iter = 0; iter < vec_len; iter++)
+            {
+                load_vec >> temp_val_one >> temp_val_two;
+                vec_one[iter] = temp_val_one;
+                vec_two[iter] = temp_val_two;
+            }
+        }
+        else
         {
-            load_vec >> temp_val_one >> temp_val_two;
-            vec_one[iter] = temp_val_one;
-            vec_two[iter] = temp_val_two;
+            // No count line: the first line is a data point, and the data points are read until the end of the file.
+            size_t expected_pairs = static_cast<size_t>(std::filesystem::file_size(file_name)) / (first_line.size() + 1) + 1;
+            vec_one.clear();
+            vec_two.clear();
+            vec_one.reserve(expected_pairs);
+            vec_two.reserve(expected_pairs);
+            if (first_stream >> temp_val_one >> temp_val_two)
+            {
+                vec_one.push_back(temp_val_one);
+                vec_two.push_back(temp_val_two);
+            }
+            while (load_vec >> temp_val_one >> temp_val_two)
+            {
+                vec_one.push_back(temp_val_one);
+                vec_two.push_back(temp_val_two);
+            }
         }
         load_vec.close();
 
@@ -88,7 +150,10 @@ public:
         validate_target_is_exist(file_name);
         validate_target_is_file(file_name);
         validate_target_format(file_name, ".csv");
-
+        if (is_standard_stream(file_name) == true)
+        {
+            return load_mapped(file_name, vec_one, vec_two); // the standard input cannot be opened with std::ifstream
+        }
 
         std::ifstream load_csv;
         load_csv.open(file_name, std::ios::in);
@@ -100,25 +165,376 @@ public:
             std::getline(load_csv, read_line);
         }
 
-        uint32_t vec_len = 0;
-        load_csv >> vec_len;
-
         double temp_val_one;
         char delimeter;
         double temp_val_two;
+        std::string first_line;
+        load_csv >> std::ws;
+        std::getline(load_csv, first_line);
+        std::istringstream first_stream(first_line);
+        if (is_count_line(first_line.data(), first_line.data() + first_line.size()) == true)
+        {
+            uint32_t vec_len = 0;
+            first_stream >> vec_len;
+            vec_one = std::vector<double>(vec_len, 0);
+            vec_two = std::vector<double>(vec_len, 0);
+            for (uint32_t iter = 0; iter < vec_len; iter++)
+            {
+                load_csv >> temp_val_one >> delimeter >> temp_val_two;
+                vec_one[iter] = temp_val_one;
+                vec_two[iter] = temp_val_two;
+            }
+        }
+        else
+        {
+            // No count line: the first line is a data point, and the data points are read until the end of the file.
+            size_t expected_pairs = static_cast<size_t>(std::filesystem::file_size(file_name)) / (first_line.size() + 1) + 1;
+            vec_one.clear();
+            vec_two.clear();
+            vec_one.reserve(expected_pairs);
+            vec_two.reserve(expected_pairs);
+            if (first_stream >> temp_val_one >> delimeter >> temp_val_two)
+            {
+                vec_one.push_back(temp_val_one);
+                vec_two.push_back(temp_val_two);
+            }
+            while (load_csv >> temp_val_one >> delimeter >> temp_val_two)
+            {
+                vec_one.push_back(temp_val_one);
+                vec_two.push_back(temp_val_two);
+            }
+        }
+        load_csv.close();
+
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function loads .dvec format file through memory mapping, and
+     * it returns vector x containing independent data and vector y containing dependent data.
+     * For accuracy in computation, the type of loaded data's element is 'double'.
+     * @details
+     * The statistics of the data points (DATA_STATS) are accumulated while the numbers are parsed, so that
+     * the regression and the plot do not read the data again for them.
+     * It throws a runtime exception if the count line or an expected number cannot be parsed.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_vec_MAPPED(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                          DATA_STATS *data_stats = nullptr)
+    {
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".dvec");
+        return load_mapped(file_name, vec_one, vec_two, data_stats);
+    }
+
+    /**
+     * @brief
+     * The function loads .csv format file through memory mapping, and
+     * it returns vector x containing independent data and vector y containing dependent data.
+     * For accuracy in computation, the type of loaded data's element is 'double'.
+     * @details
+     * The statistics of the data points (DATA_STATS) are accumulated while the numbers are parsed, so that
+     * the regression and the plot do not read the data again for them.
+     * It throws a runtime exception if the count line or an expected number cannot be parsed.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_csv_MAPPED(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                          DATA_STATS *data_stats = nullptr)
+    {
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".csv");
+        return load_mapped(file_name, vec_one, vec_two, data_stats);
+    }
+
+    /**
+     * @brief
+     * The function loads .dvec format file through memory mapping and parses it on multiple threads, and
+     * it returns vector x containing independent data and vector y containing dependent data.
+     * For accuracy in computation, the type of loaded data's element is 'double'.
+     * @details
+     * The data lines are split into chunks of about chunk_bytes bytes at line breaks,
+     * each chunk is parsed into its own buffers concurrently, and
+     * the buffers are copied into the output vectors in the order of the chunks; therefore,
+     * the result is the same as load_vec_MAPPED().
+     * It throws a runtime exception if the count line or an expected number cannot be parsed.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] thread_pool Threads used for parsing.
+     * @param[in] chunk_bytes The number of bytes parsed by a task, zero means default_parse_chunk_bytes.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_vec_PARALLEL(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                           THREAD_POOL &thread_pool, const size_t chunk_bytes = 0, DATA_STATS *data_stats = nullptr)
+    {
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".dvec");
+        return load_mapped_parallel(file_name, vec_one, vec_two, thread_pool, chunk_bytes, data_stats);
+    }
+
+    /**
+     * @brief
+     * The function loads .csv format file through memory mapping and parses it on multiple threads, and
+     * it returns vector x containing independent data and vector y containing dependent data.
+     * For accuracy in computation, the type of loaded data's element is 'double'.
+     * @details
+     * The data lines are split into chunks of about chunk_bytes bytes at line breaks,
+     * each chunk is parsed into its own buffers concurrently, and
+     * the buffers are copied into the output vectors in the order of the chunks; therefore,
+     * the result is the same as load_csv_MAPPED().
+     * It throws a runtime exception if the count line or an expected number cannot be parsed.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] thread_pool Threads used for parsing.
+     * @param[in] chunk_bytes The number of bytes parsed by a task, zero means default_parse_chunk_bytes.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_csv_PARALLEL(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                           THREAD_POOL &thread_pool, const size_t chunk_bytes = 0, DATA_STATS *data_stats = nullptr)
+    {
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".csv");
+        return load_mapped_parallel(file_name, vec_one, vec_two, thread_pool, chunk_bytes, data_stats);
+    }
+
+    /**
+     * @brief
+     * The function loads .dbin format file into a DATA_SET object without parsing or copying the data.
+     * @details
+     * The file is mapped into memory, and the DATA_SET object refers to the columns in the mapping.
+     * The mapping is kept until every DATA_SET object sharing the data is destroyed.
+     * The statistics footer, if the file has one, is attached to the DATA_SET object.
+     * The header is validated; it throws a runtime exception if the file is not a .dbin file
+     * written on a machine of the same byte order.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] observed_data The DATA_SET object that refers to the loaded data.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_dbin(const std::string file_name, DATA_SET &observed_data)
+    {
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".dbin");
+
+        auto mapped_file = std::make_shared<const MAPPED_FILE>(file_name);
+        return load_dbin(file_name, mapped_file, mapped_file->get_view(), observed_data);
+    }
+
+    /**
+     * @brief
+     * The function loads the content of .dbin format file that has been read into memory,
+     * e.g. by ASYNC_FILE_READER, into a DATA_SET object without copying the data.
+     * The DATA_SET object refers to the columns in file_text and keeps owner alive.
+     * The header and the statistics footer are handled as load_dbin() does.
+     *
+     * @param[in] file_name Path to the file, used in the error messages.
+     * @param[in] owner The object that holds file_text, aligned for double.
+     * @param[in] file_text The whole content of the file.
+     * @param[out] observed_data The DATA_SET object that refers to the loaded data.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
+     */
+    bool load_dbin(const std::string &file_name, std::shared_ptr<const void> owner, std::string_view file_text, DATA_SET &observed_data)
+    {
+        DBIN_HEADER dbin_header;
+        if (file_text.size() < sizeof(DBIN_HEADER))
+        {
+            throw_dbin_error(file_name, "The file is smaller than the header.");
+        }
+        std::memcpy(&dbin_header, file_text.data(), sizeof(DBIN_HEADER));
+        validate_dbin_header(dbin_header, file_text.size(), file_name);
+
+        size_t num_data_points = static_cast<size_t>(dbin_header.num_data_points);
+        std::span<const double> x_observed(reinterpret_cast<const double *>(file_text.data() + dbin_header.x_offset), num_data_points);
+        std::span<const double> y_observed(reinterpret_cast<const double *>(file_text.data() + dbin_header.y_offset), num_data_points);
+        std::shared_ptr<const BLOCK_STATS> block_stats = read_dbin_stats(dbin_header, file_text, file_name);
+        observed_data = DATA_SET(std::move(owner), x_observed, y_observed, std::move(block_stats));
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function parses the content of .dvec or .csv format file that has been read into memory
+     * with std::from_chars, e.g. by ASYNC_FILE_READER, as MAPPED methods do.
+     * It throws a runtime exception if the count line or an expected number cannot be parsed.
+     *
+     * @param[in] file_name Path to the file, used in the error messages.
+     * @param[in] file_text The whole content of the file.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     */
+    bool load_text(const std::string &file_name, std::string_view file_text, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                   DATA_STATS *data_stats = nullptr)
+    {
+        const char *text_end = file_text.data() + file_text.size();
+
+        uint32_t vec_len = 0;
+        bool has_count = false;
+        const char *read_ptr = parse_header(file_text, file_name, vec_len, has_count);
+
+        if (has_count == false)
+        {
+            vec_one.clear();
+            vec_two.clear();
+            size_t failed_pair = parse_pairs_until(read_ptr, text_end, vec_one, vec_two, data_stats);
+            if (failed_pair != std::string::npos)
+            {
+                throw_parse_error(file_name, failed_pair);
+            }
+            return true;
+        }
         vec_one = std::vector<double>(vec_len, 0);
         vec_two = std::vector<double>(vec_len, 0);
-        for (uint32_t iter = 0; iter < vec_len; iter++)
+        parse_pairs(read_ptr, text_end, file_name, 0, vec_len, vec_one.data(), vec_two.data(), data_stats);
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function validates the content of .dvec or .csv format file that has been read into memory,
+     * e.g. decompressed from .gz or .zst file, while parsing it in a single pass as SAFE methods do.
+     * It throws a runtime exception with the line and the column of the first error.
+     *
+     * @param[in] file_name Path to the file, used in the error messages.
+     * @param[in] file_text The whole content of the file.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] delimiter The character separating two numbers of a data line, ' ' or ','.
+     * @return true When data load is succeeded.
+     */
+    bool load_text_SAFE(const std::string &file_name, std::string_view file_text, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                        const char delimiter)
+    {
+        TEXT_CURSOR cursor;
+        cursor.read_ptr = file_text.data();
+        cursor.text_end = file_text.data() + file_text.size();
+        cursor.line_begin = cursor.read_ptr;
+
+        while (cursor.read_ptr < cursor.text_end && *cursor.read_ptr == '%')
         {
-            load_csv >> temp_val_one >> delimeter >> temp_val_two;
-            vec_one[iter] = temp_val_one;
-            vec_two[iter] = temp_val_two;
+            move_to_next_line(cursor);
+        }
+
+        // A file without the count line starts with a data line, and its data points are read until the end of the file.
+        bool has_count = is_count_line(cursor.read_ptr, cursor.text_end);
+        uint32_t vec_len = 0;
+        if (has_count == true)
+        {
+            skip_blank(cursor);
+            auto [end_ptr, error_code] = std::from_chars(cursor.read_ptr, cursor.text_end, vec_len);
+            if (error_code != std::errc())
+            {
+                throw_format_error(cursor, file_name, "The number of data points is out of range.");
+            }
+            cursor.read_ptr = end_ptr;
+            is_line_end(cursor);
+        }
+        else if (is_line_end(cursor) == true)
+        {
+            throw_format_error(cursor, file_name, "The number of data points or a data point is expected.");
+        }
+        else
+        {
+            cursor.read_ptr = cursor.line_begin;
+        }
+
+        // Every data line takes at least 4 bytes, so a count larger than the file does not allocate memory.
+        size_t max_pairs = static_cast<size_t>(cursor.text_end - cursor.read_ptr) / 4 + 1;
+        size_t expected_pairs = (has_count == true) ? std::min<size_t>(vec_len, max_pairs) : estimate_num_pairs(cursor.read_ptr, cursor.text_end);
+        vec_one.clear();
+        vec_two.clear();
+        vec_one.reserve(expected_pairs);
+        vec_two.reserve(expected_pairs);
+        for (size_t iter = 0; has_count == false || iter < vec_len; iter++)
+        {
+            if (has_count == true || iter > 0)
+            {
+                move_to_next_line(cursor);
+            }
+            while (cursor.read_ptr < cursor.text_end && is_line_end(cursor) == true)
+            {
+                move_to_next_line(cursor); // empty lines between the data points are skipped as the other methods do
+            }
+            if (cursor.read_ptr == cursor.text_end && has_count == false)
+            {
+                break;
+            }
+            if (cursor.read_ptr == cursor.text_end)
+            {
+                throw_format_error(cursor, file_name,
+                                   "The file ends after " + std::to_string(iter) + " of " + std::to_string(vec_len) + " data points.");
+            }
+            skip_blank(cursor);
+            vec_one.push_back(parse_safe_number(cursor, file_name, "X"));
+            if (delimiter == ',')
+            {
+                skip_blank(cursor);
+                if (cursor.read_ptr == cursor.text_end || *cursor.read_ptr != ',')
+                {
+                    throw_format_error(cursor, file_name, "A comma is expected between X and Y.");
+                }
+                cursor.read_ptr++;
+            }
+            else if (cursor.read_ptr == cursor.text_end || (*cursor.read_ptr != ' ' && *cursor.read_ptr != '\t'))
+            {
+                throw_format_error(cursor, file_name, "A space is expected between X and Y.");
+            }
+            skip_blank(cursor);
+            vec_two.push_back(parse_safe_number(cursor, file_name, "Y"));
+            if (is_line_end(cursor) == false)
+            {
+                throw_format_error(cursor, file_name, "Unexpected character after Y.");
+            }
         }
-        load_csv.close();
 
+        while (cursor.read_ptr < cursor.text_end)
+        {
+            move_to_next_line(cursor);
+            if (is_line_end(cursor) == false)
+            {
+                throw_format_error(cursor, file_name,
+                                   "Unexpected content after the last data point; the count line says " + std::to_string(vec_len) + ".");
+            }
+        }
         return true;
     }
 
+    /**
+     * @brief
+     * The number of bytes parsed by a task of PARALLEL methods.
+     * It is large enough to make the scheduling cost negligible and small enough to balance the threads.
+     *
+     */
+    static constexpr size_t default_parse_chunk_bytes = size_t(4) << 20;
+
     /**
      * @brief
      * The function loads .dvec format file, and
@@ -134,7 +550,10 @@ public:
      */
     bool load_vec_SAFE(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two)
     {
-        return false;
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".dvec");
+        return load_safe(file_name, vec_one, vec_two, ' ');
     }
 
     /**
@@ -152,60 +571,1036 @@ public:
      */
     bool load_csv_SAFE(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two)
     {
-        return false;
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(file_name, ".csv");
+        return load_safe(file_name, vec_one, vec_two, ',');
     }
 
-private:
     /**
      * @brief
-     *  The function validates the existence of the received path and
-     *  throws a "runtime exception" if the path does not exist.
+     * The function loads .dbin format file into a DATA_SET object as load_dbin() does, and
+     * checks that every loaded value is a finite number.
+     * It throws a runtime exception with the index of the first data point holding NaN or infinity.
      *
-     * @param[in] file_name The path to the targeted file.
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] observed_data The DATA_SET object that refers to the loaded data.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
      */
-    void validate_target_is_exist(const std::string &file_name)
+    bool load_dbin_SAFE(const std::string file_name, DATA_SET &observed_data)
     {
-        std::filesystem::path file_path(file_name);
-        if (std::filesystem::exists(file_path) == false)
+        DATA_SET loaded_data;
+        load_dbin(file_name, loaded_data);
+
+        std::span<const double> x_loaded = loaded_data.get_x();
+        std::span<const double> y_loaded = loaded_data.get_y();
+        for (size_t iter = 0; iter < loaded_data.size(); iter++)
         {
-            std::string error_message =
-                "READ ERROR - FILE DOES NOT EXIST.\n"
-                "There is no such file exists at the given path.\n"
-                "Received path - " + file_name + "\n";
-            throw std::invalid_argument(error_message);
+            if (std::isfinite(x_loaded[iter]) == false || std::isfinite(y_loaded[iter]) == false)
+            {
+                std::string error_message =
+                    "READ ERROR - INVALID DATA FORMAT.\n"
+                    "Data point " + std::to_string(iter + 1) + " of " + file_name + " is not a finite number.\n";
+                throw std::runtime_error(error_message);
+            }
         }
+        observed_data = std::move(loaded_data);
+        return true;
     }
 
     /**
      * @brief
-     *  The function validates the targeted path is a file and
-     *  throws a "runtime exception" if the path is not a file.
+     * The function loads two columns of a multi-column .csv format file, and
+     * it returns vector x containing independent data and vector y containing dependent data.
+     * For accuracy in computation, the type of loaded data's element is 'double'.
+     * @details
+     * The file is mapped into memory, or decompressed into memory if it is .csv.gz or .csv.zst file.
+     * Only the selected fields of a data line are parsed with std::from_chars; the fields before them are skipped
+     * by searching the commas, and the rest of the line is skipped by searching the line break.
+     * The selected fields are validated as SAFE methods do, and
+     * it throws a runtime exception with the line and the column of the first error.
+     * See CSV_COLUMNS for the layout of the file.
      *
-     * @param[in] file_name The path to the targeted file.
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] csv_columns The columns loaded as X-Axis and Y-Axis.
+     * @return true When data load is succeeded.
+     * @return false When data load is failed.
      */
-    void validate_target_is_file(const std::string &file_name)
+    bool load_csv_COLUMNS(const std::string file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                          const CSV_COLUMNS &csv_columns)
     {
-        std::filesystem::path file_path(file_name);
-        if (std::filesystem::is_regular_file(file_path) == false)
+        validate_target_is_exist(file_name);
+        validate_target_is_file(file_name);
+        validate_target_format(remove_compression_extension(file_name).string(), ".csv");
+
+        if (get_compression(file_name) != COMPRESSION::NONE)
         {
-            std::string error_message =
-                "READ ERROR - INCORRECT INPUT.\n"
-                "Input needs to be path to a file\n"
-                "But the given path - " + file_name + " - is not a file.\n";
-            throw std::invalid_argument(error_message);
+            validate_compression_supported(file_name, "READ ERROR");
+            std::string file_text = read_decompressed(file_name);
+            return parse_csv_columns(file_text, file_name, csv_columns, vec_one, vec_two);
         }
+        MAPPED_FILE mapped_file(file_name);
+        return parse_csv_columns(mapped_file.get_view(), file_name, csv_columns, vec_one, vec_two);
     }
 
+private:
     /**
      * @brief
-     * The function validates the file format is correct and 
-     * throws a "runtime exception" if the format is not supported.
+     * Position of SAFE methods in the text, used to report the line and the column of an error.
      *
-     * @param[in] file_name The path to the targeted file.
-     * @param[in] target_format The required file format.
      */
-    void validate_target_format(const std::string file_name, const std::string target_format)
+    struct TEXT_CURSOR
+    {
+        const char *read_ptr = nullptr;
+        const char *text_end = nullptr;
+        const char *line_begin = nullptr;
+        size_t line_number = 1;
+    };
+
+    /**
+     * @brief
+     * The function maps .dvec or .csv format file and validates it while parsing it in a single pass.
+     * @details
+     * The file must consist of
+     * - comment lines starting with '%' (optional)
+     * - the count line holding the number of data points (optional)
+     * - exactly as many data lines as the count, or data lines up to the end of the file if there is no count line,
+     *   each holding two finite numbers separated by spaces or tabs (delimiter ' ') or by a comma (delimiter ','),
+     *   with optional spaces or tabs at the beginning and the end of the line
+     * - empty lines between and after the data lines (optional), skipped as the other methods do
+     * A line may end with "\r\n". It throws a runtime exception with the line and the column of the first error.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] delimiter The character separating two numbers of a data line, ' ' or ','.
+     * @return true When data load is succeeded.
+     */
+    bool load_safe(const std::string &file_name, std::vector<double> &vec_one, std::vector<double> &vec_two, const char delimiter)
+    {
+        MAPPED_FILE mapped_file(file_name);
+        return load_text_SAFE(file_name, mapped_file.get_view(), vec_one, vec_two, delimiter);
+    }
+
+    /**
+     * @brief
+     * The function parses a finite number at the cursor for SAFE methods and moves the cursor after it.
+     * A leading '+' is accepted as std::ifstream does.
+     * It throws a runtime exception if the number is missing, malformed, out of the range of double, NaN or infinity.
+     *
+     * @param[in,out] cursor Position in the text.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] value_name Name of the number, used for the error message.
+     * @return double
+     */
+    static double parse_safe_number(TEXT_CURSOR &cursor, const std::string &file_name, const std::string &value_name)
+    {
+        const char *number_begin = cursor.read_ptr;
+        if (number_begin < cursor.text_end && *number_begin == '+' &&
+            number_begin + 1 < cursor.text_end && number_begin[1] != '-')
+        {
+            number_begin++;
+        }
+        double value = 0;
+        auto [end_ptr, error_code] = std::from_chars(number_begin, cursor.text_end, value);
+        if (error_code == std::errc::result_out_of_range)
+        {
+            throw_format_error(cursor, file_name, value_name + " is out of the range of double.");
+        }
+        if (error_code != std::errc())
+        {
+            throw_format_error(cursor, file_name, "A number for " + value_name + " is expected.");
+        }
+        if (std::isfinite(value) == false)
+        {
+            throw_format_error(cursor, file_name, value_name + " is not a finite number.");
+        }
+        if (end_ptr < cursor.text_end &&
+            *end_ptr != ' ' && *end_ptr != '\t' && *end_ptr != ',' && *end_ptr != '\r' && *end_ptr != '\n')
+        {
+            cursor.read_ptr = end_ptr;
+            throw_format_error(cursor, file_name, "Unexpected character after " + value_name + ".");
+        }
+        cursor.read_ptr = end_ptr;
+        return value;
+    }
+
+    /**
+     * @brief The function skips spaces and tabs for SAFE methods.
+     *
+     * @param[in,out] cursor Position in the text.
+     */
+    static void skip_blank(TEXT_CURSOR &cursor)
+    {
+        while (cursor.read_ptr < cursor.text_end && (*cursor.read_ptr == ' ' || *cursor.read_ptr == '\t'))
+        {
+            cursor.read_ptr++;
+        }
+    }
+
+    /**
+     * @brief
+     * The function skips spaces, tabs and '\r' before the line break for SAFE methods and
+     * checks that nothing else is left on the line.
+     *
+     * @param[in,out] cursor Position in the text, moved to the line break or the end of the text.
+     * @return true When the rest of the line is blank.
+     * @return false Otherwise, the cursor points the first unexpected character.
+     */
+    static bool is_line_end(TEXT_CURSOR &cursor)
     {
+        skip_blank(cursor);
+        if (cursor.read_ptr < cursor.text_end && *cursor.read_ptr == '\r' &&
+            (cursor.read_ptr + 1 == cursor.text_end || cursor.read_ptr[1] == '\n'))
+        {
+            cursor.read_ptr++;
+        }
+        return cursor.read_ptr == cursor.text_end || *cursor.read_ptr == '\n';
+    }
+
+    /**
+     * @brief The function moves the cursor to the beginning of the next line, or to the end of the text.
+     *
+     * @param[in,out] cursor Position in the text.
+     */
+    static void move_to_next_line(TEXT_CURSOR &cursor)
+    {
+        const char *line_end = static_cast<const char *>(std::memchr(cursor.read_ptr, '\n', cursor.text_end - cursor.read_ptr));
+        if (line_end == nullptr)
+        {
+            cursor.read_ptr = cursor.text_end;
+            return;
+        }
+        cursor.read_ptr = line_end + 1;
+        cursor.line_begin = cursor.read_ptr;
+        cursor.line_number++;
+    }
+
+    /**
+     * @brief
+     * The function parses the selected columns of a multi-column .csv text for load_csv_COLUMNS().
+     * A header line is expected if a column is selected by name; otherwise,
+     * the first line is a header line only if its X field is not a number.
+     * Empty lines are skipped, and a line break inside a quoted field is not supported.
+     *
+     * @param[in] file_text The whole text of the file.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] csv_columns The columns loaded as X-Axis and Y-Axis.
+     * @param[out] vec_one The vector that stores the values of the X-Axis column.
+     * @param[out] vec_two The vector that stores the values of the Y-Axis column.
+     * @return true When data load is succeeded.
+     */
+    static bool parse_csv_columns(std::string_view file_text, const std::string &file_name, const CSV_COLUMNS &csv_columns,
+                                  std::vector<double> &vec_one, std::vector<double> &vec_two)
+    {
+        TEXT_CURSOR cursor;
+        cursor.read_ptr = file_text.data();
+        cursor.text_end = file_text.data() + file_text.size();
+        cursor.line_begin = cursor.read_ptr;
+
+        while (cursor.read_ptr < cursor.text_end && *cursor.read_ptr == '%')
+        {
+            move_to_next_line(cursor);
+        }
+
+        bool has_count = is_count_line(cursor.read_ptr, cursor.text_end);
+        uint32_t vec_len = 0;
+        if (has_count == true)
+        {
+            skip_blank(cursor);
+            auto [end_ptr, error_code] = std::from_chars(cursor.read_ptr, cursor.text_end, vec_len);
+            if (error_code != std::errc())
+            {
+                throw_format_error(cursor, file_name, "The number of data points is out of range.");
+            }
+            move_to_next_line(cursor);
+        }
+
+        size_t x_index = csv_columns.x_column.index;
+        size_t y_index = csv_columns.y_column.index;
+        bool has_header = csv_columns.x_column.name.empty() == false || csv_columns.y_column.name.empty() == false;
+        if (has_header == false && cursor.read_ptr < cursor.text_end)
+        {
+            const char *line_end = find_line_end(cursor.read_ptr, cursor.text_end);
+            const char *field_begin = cursor.read_ptr;
+            for (size_t iter = 0; iter < x_index && field_begin < line_end; iter++)
+            {
+                field_begin = skip_csv_field(field_begin, line_end) + 1;
+            }
+            double value = 0;
+            has_header = field_begin >= line_end || try_parse_number(field_begin, line_end, value) == nullptr;
+        }
+        if (has_header == true)
+        {
+            std::vector<std::string> column_names = split_csv_header(cursor.read_ptr, find_line_end(cursor.read_ptr, cursor.text_end));
+            x_index = find_csv_column(column_names, csv_columns.x_column, file_name);
+            y_index = find_csv_column(column_names, csv_columns.y_column, file_name);
+            move_to_next_line(cursor);
+        }
+        size_t last_index = std::max(x_index, y_index);
+
+        // Every data line takes at least 4 bytes, so a count larger than the file does not allocate memory.
+        size_t max_pairs = static_cast<size_t>(cursor.text_end - cursor.read_ptr) / 4 + 1;
+        size_t expected_pairs = (has_count == true) ? std::min<size_t>(vec_len, max_pairs) : estimate_num_pairs(cursor.read_ptr, cursor.text_end);
+        vec_one.clear();
+        vec_two.clear();
+        vec_one.reserve(expected_pairs);
+        vec_two.reserve(expected_pairs);
+        double x_value = 0;
+        double y_value = 0;
+        while (cursor.read_ptr < cursor.text_end && (has_count == false || vec_one.size() < vec_len))
+        {
+            const char *line_end = find_line_end(cursor.read_ptr, cursor.text_end);
+            if (is_line_end(cursor) == true)
+            {
+                move_to_next_line(cursor);
+                continue;
+            }
+            cursor.read_ptr = cursor.line_begin;
+            for (size_t iter = 0; iter <= last_index; iter++)
+            {
+                if (iter == x_index || iter == y_index)
+                {
+                    skip_blank(cursor);
+                    double value = parse_safe_number(cursor, file_name, (iter == x_index) ? "X" : "Y");
+                    x_value = (iter == x_index) ? value : x_value;
+                    y_value = (iter == y_index) ? value : y_value;
+                    is_line_end(cursor);
+                    if (cursor.read_ptr < line_end && *cursor.read_ptr != ',')
+                    {
+                        throw_format_error(cursor, file_name, "A comma is expected after column " + std::to_string(iter) + ".");
+                    }
+                }
+                else
+                {
+                    cursor.read_ptr = skip_csv_field(cursor.read_ptr, line_end);
+                }
+                if (iter < last_index)
+                {
+                    if (cursor.read_ptr >= line_end)
+                    {
+                        throw_format_error(cursor, file_name, "Column " + std::to_string(last_index) + " is expected, but the line has only " +
+                                                                  std::to_string(iter + 1) + " columns.");
+                    }
+                    cursor.read_ptr++;
+                }
+            }
+            vec_one.push_back(x_value);
+            vec_two.push_back(y_value);
+            move_to_next_line(cursor);
+        }
+
+        if (has_count == true && vec_one.size() < vec_len)
+        {
+            throw_format_error(cursor, file_name,
+                               "The file ends after " + std::to_string(vec_one.size()) + " of " + std::to_string(vec_len) + " data points.");
+        }
+        return true;
+    }
+
+    /**
+     * @brief The function finds the line break at the end of the line, or the end of the text.
+     *
+     * @param[in] read_ptr A position in the line.
+     * @param[in] text_end The end of the text.
+     * @return const char*
+     */
+    static const char *find_line_end(const char *read_ptr, const char *text_end)
+    {
+        const char *line_end = static_cast<const char *>(std::memchr(read_ptr, '\n', text_end - read_ptr));
+        return (line_end == nullptr) ? text_end : line_end;
+    }
+
+    /**
+     * @brief The function skips a field of a .csv line without parsing it; a field in double quotes may hold commas.
+     *
+     * @param[in] read_ptr The beginning of the field.
+     * @param[in] line_end The end of the line.
+     * @return const char* The position of the comma after the field, or line_end.
+     */
+    static const char *skip_csv_field(const char *read_ptr, const char *line_end)
+    {
+        while (read_ptr < line_end && (*read_ptr == ' ' || *read_ptr == '\t'))
+        {
+            read_ptr++;
+        }
+        if (read_ptr < line_end && *read_ptr == '"')
+        {
+            read_ptr++;
+            while (read_ptr < line_end)
+            {
+                const char *quote = static_cast<const char *>(std::memchr(read_ptr, '"', line_end - read_ptr));
+                if (quote == nullptr)
+                {
+                    return line_end;
+                }
+                read_ptr = quote + 1;
+                if (read_ptr == line_end || *read_ptr != '"')
+                {
+                    break; // closing quote, "" is an escaped quote
+                }
+                read_ptr++;
+            }
+        }
+        const char *comma = static_cast<const char *>(std::memchr(read_ptr, ',', line_end - read_ptr));
+        return (comma == nullptr) ? line_end : comma;
+    }
+
+    /**
+     * @brief The function splits the header line of a .csv file into the names of the columns without blanks and quotes.
+     *
+     * @param[in] read_ptr The beginning of the header line.
+     * @param[in] line_end The end of the header line.
+     * @return std::vector<std::string>
+     */
+    static std::vector<std::string> split_csv_header(const char *read_ptr, const char *line_end)
+    {
+        std::vector<std::string> column_names;
+        while (true)
+        {
+            const char *field_end = skip_csv_field(read_ptr, line_end);
+            std::string_view column_name(read_ptr, static_cast<size_t>(field_end - read_ptr));
+            while (column_name.empty() == false && std::isspace(static_cast<unsigned char>(column_name.front())))
+            {
+                column_name.remove_prefix(1);
+            }
+            while (column_name.empty() == false && std::isspace(static_cast<unsigned char>(column_name.back())))
+            {
+                column_name.remove_suffix(1);
+            }
+            if (column_name.size() >= 2 && column_name.front() == '"' && column_name.back() == '"')
+            {
+                column_name = column_name.substr(1, column_name.size() - 2);
+            }
+            column_names.emplace_back(column_name);
+            if (field_end == line_end)
+            {
+                return column_names;
+            }
+            read_ptr = field_end + 1;
+        }
+    }
+
+    /**
+     * @brief
+     * The function finds the index of the selected column in the header line.
+     * It throws a runtime exception if the name is not in the header line or the index is out of it.
+     *
+     * @param[in] column_names Names of the columns in the header line.
+     * @param[in] csv_column The selected column.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @return size_t
+     */
+    static size_t find_csv_column(const std::vector<std::string> &column_names, const CSV_COLUMN &csv_column, const std::string &file_name)
+    {
+        if (csv_column.name.empty() == true)
+        {
+            if (csv_column.index >= column_names.size())
+            {
+                std::string error_message =
+                    "READ ERROR - COLUMN IS NOT FOUND.\n"
+                    "Column " + std::to_string(csv_column.index) + " is out of the " + std::to_string(column_names.size()) +
+                    " columns in the header line of " + file_name + "\n";
+                throw std::runtime_error(error_message);
+            }
+            return csv_column.index;
+        }
+        auto found_name = std::find(column_names.begin(), column_names.end(), csv_column.name);
+        if (found_name == column_names.end())
+        {
+            std::string error_message =
+                "READ ERROR - COLUMN IS NOT FOUND.\n"
+                "Column " + csv_column.name + " is not in the header line of " + file_name + "\n";
+            throw std::runtime_error(error_message);
+        }
+        return static_cast<size_t>(found_name - column_names.begin());
+    }
+
+    /**
+     * @brief The function decompresses the whole .gz or .zst file into memory.
+     *
+     * @param[in] file_name Path to the compressed file.
+     * @return std::string The decompressed text.
+     */
+    static std::string read_decompressed(const std::string &file_name)
+    {
+        constexpr size_t read_bytes = size_t(1) << 20;
+        DECOMPRESS_STREAM decompress_stream(file_name);
+        std::string file_text;
+        size_t text_size = 0;
+        while (true)
+        {
+            if (file_text.size() < text_size + read_bytes)
+            {
+                file_text.resize(std::max(file_text.size() * 2, text_size + read_bytes));
+            }
+            size_t num_read = decompress_stream.read(file_text.data() + text_size, read_bytes);
+            text_size += num_read;
+            if (num_read < read_bytes)
+            {
+                file_text.resize(text_size);
+                return file_text;
+            }
+        }
+    }
+
+    /**
+     * @brief The function throws a runtime exception with the line and the column of the cursor.
+     *
+     * @param[in] cursor Position of the error in the text.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] reason The reason the data is invalid.
+     */
+    [[noreturn]] static void throw_format_error(const TEXT_CURSOR &cursor, const std::string &file_name, const std::string &reason)
+    {
+        std::string error_message =
+            "READ ERROR - INVALID DATA FORMAT.\n"
+            "Line " + std::to_string(cursor.line_number) + ", column " + std::to_string(cursor.read_ptr - cursor.line_begin + 1) +
+            " of " + file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+
+    /**
+     * @brief
+     * The function maps .dvec or .csv format file and parses it with std::from_chars.
+     * Both formats are parsed by the same function as spaces, tabs, line breaks and commas are all separators.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     */
+    bool load_mapped(const std::string &file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                     DATA_STATS *data_stats = nullptr)
+    {
+        MAPPED_FILE mapped_file(file_name);
+        return load_text(file_name, mapped_file.get_view(), vec_one, vec_two, data_stats);
+    }
+
+    /**
+     * @brief
+     * The function maps .dvec or .csv format file and parses it by chunks on the thread pool.
+     * The statistics of each chunk are accumulated while it is parsed and merged in the order of the chunks.
+     *
+     * @param[in] file_name Path to the file that will be loaded.
+     * @param[out] vec_one The vector that stores the independent values (X-Axis) of the observed data.
+     * @param[out] vec_two The vector that stores the independent values (Y-Axis) of the observed data.
+     * @param[in] thread_pool Threads used for parsing.
+     * @param[in] chunk_bytes The number of bytes parsed by a task, zero means default_parse_chunk_bytes.
+     * @param[out] data_stats Statistics of the loaded data points accumulated while parsing, not computed if it is null.
+     * @return true When data load is succeeded.
+     */
+    bool load_mapped_parallel(const std::string &file_name, std::vector<double> &vec_one, std::vector<double> &vec_two,
+                              THREAD_POOL &thread_pool, size_t chunk_bytes, DATA_STATS *data_stats = nullptr)
+    {
+        struct PARSED_CHUNK
+        {
+            std::vector<double> values_one;
+            std::vector<double> values_two;
+            DATA_STATS chunk_stats;
+            size_t failed_pair = std::string::npos; // index of the pair failed to be parsed in the chunk
+            size_t first_pair = 0;                  // index of the first pair of the chunk in the file
+        };
+
+        MAPPED_FILE mapped_file(file_name);
+        std::string_view file_text = mapped_file.get_view();
+        const char *text_end = file_text.data() + file_text.size();
+
+        uint32_t vec_len = 0;
+        bool has_count = false;
+        const char *read_ptr = parse_header(file_text, file_name, vec_len, has_count);
+        size_t num_data_points = (has_count == true) ? vec_len : SIZE_MAX; // a file without the count line is read to the end
+
+        chunk_bytes = (chunk_bytes == 0) ? default_parse_chunk_bytes : chunk_bytes;
+        std::vector<const char *> chunk_begins;
+        while (read_ptr < text_end)
+        {
+            chunk_begins.push_back(read_ptr);
+            read_ptr += std::min<size_t>(chunk_bytes, text_end - read_ptr);
+            if (read_ptr < text_end)
+            {
+                const char *line_end = static_cast<const char *>(std::memchr(read_ptr, '\n', text_end - read_ptr));
+                read_ptr = (line_end == nullptr) ? text_end : line_end + 1;
+            }
+        }
+        chunk_begins.push_back(text_end);
+
+        std::vector<PARSED_CHUNK> parsed_chunks(chunk_begins.size() - 1);
+        thread_pool.parallel_for(parsed_chunks.size(), [&](size_t chunk_index, uint32_t)
+                                 {
+                                     PARSED_CHUNK &parsed_chunk = parsed_chunks[chunk_index];
+                                     parsed_chunk.failed_pair = parse_pairs_until(
+                                         chunk_begins[chunk_index], chunk_begins[chunk_index + 1],
+                                         parsed_chunk.values_one, parsed_chunk.values_two,
+                                         (data_stats != nullptr) ? &parsed_chunk.chunk_stats : nullptr); });
+
+        size_t num_parsed = 0;
+        for (auto &parsed_chunk : parsed_chunks)
+        {
+            parsed_chunk.first_pair = num_parsed;
+            if (parsed_chunk.failed_pair != std::string::npos && num_parsed + parsed_chunk.failed_pair < num_data_points)
+            {
+                throw_parse_error(file_name, num_parsed + parsed_chunk.failed_pair);
+            }
+            num_parsed += parsed_chunk.values_one.size();
+        }
+        if (has_count == false)
+        {
+            num_data_points = num_parsed;
+        }
+        else if (num_parsed < num_data_points)
+        {
+            throw_parse_error(file_name, num_parsed);
+        }
+
+        vec_one = std::vector<double>(num_data_points, 0);
+        vec_two = std::vector<double>(num_data_points, 0);
+        thread_pool.parallel_for(parsed_chunks.size(), [&](size_t chunk_index, uint32_t)
+                                 {
+                                     PARSED_CHUNK &parsed_chunk = parsed_chunks[chunk_index];
+                                     if (parsed_chunk.first_pair >= num_data_points)
+                                     {
+                                         return;
+                                     }
+                                     size_t num_copied = std::min(parsed_chunk.values_one.size(), num_data_points - parsed_chunk.first_pair);
+                                     std::copy_n(parsed_chunk.values_one.begin(), num_copied, vec_one.begin() + parsed_chunk.first_pair);
+                                     std::copy_n(parsed_chunk.values_two.begin(), num_copied, vec_two.begin() + parsed_chunk.first_pair);
+                                     if (data_stats != nullptr && num_copied < parsed_chunk.values_one.size())
+                                     {
+                                         // the chunk holds lines after the number of data points in the count line
+                                         parsed_chunk.chunk_stats = DATA_STATS();
+                                         parsed_chunk.chunk_stats.accumulate(std::span<const double>(parsed_chunk.values_one).first(num_copied),
+                                                                             std::span<const double>(parsed_chunk.values_two).first(num_copied));
+                                     } });
+        if (data_stats != nullptr)
+        {
+            for (const auto &parsed_chunk : parsed_chunks)
+            {
+                if (parsed_chunk.first_pair < num_data_points)
+                {
+                    data_stats->merge(parsed_chunk.chunk_stats);
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function skips the comment lines starting with '%' and parses the count line.
+     * A file without the count line starts with a data line; see is_count_line().
+     * It throws a runtime exception if neither the count nor a data point is found.
+     *
+     * @param[in] file_text The whole text of the file.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[out] vec_len The number of data points written in the count line, zero if there is no count line.
+     * @param[out] has_count Whether the file has the count line.
+     * @return const char* The position right after the count, or of the first data point if there is no count line.
+     */
+    static const char *parse_header(std::string_view file_text, const std::string &file_name, uint32_t &vec_len, bool &has_count)
+    {
+        const char *read_ptr = file_text.data();
+        const char *text_end = file_text.data() + file_text.size();
+        while (read_ptr < text_end && *read_ptr == '%')
+        {
+            const char *line_end = static_cast<const char *>(std::memchr(read_ptr, '\n', text_end - read_ptr));
+            read_ptr = (line_end == nullptr) ? text_end : line_end + 1;
+        }
+
+        read_ptr = skip_separator(read_ptr, text_end);
+        vec_len = 0;
+        has_count = is_count_line(read_ptr, text_end);
+        if (has_count == false && read_ptr < text_end)
+        {
+            return read_ptr;
+        }
+        auto [end_ptr, error_code] = std::from_chars(read_ptr, text_end, vec_len);
+        if (error_code != std::errc())
+        {
+            std::string error_message =
+                "READ ERROR - FAILED TO PARSE A NUMBER.\n"
+                "The number of data points is expected at the beginning of " + file_name + "\n";
+            throw std::runtime_error(error_message);
+        }
+        return end_ptr;
+    }
+
+    /**
+     * @brief
+     * The function checks that the line at read_ptr holds only a non-negative integer, the count of data points.
+     * Otherwise the line is the first data line of a file without the count line.
+     *
+     * @param[in] read_ptr The beginning of the line, spaces and tabs before the count are skipped.
+     * @param[in] text_end The end of the text.
+     * @return true When the line is the count line.
+     * @return false When the line holds anything else.
+     */
+    static bool is_count_line(const char *read_ptr, const char *text_end)
+    {
+        while (read_ptr < text_end && (*read_ptr == ' ' || *read_ptr == '\t'))
+        {
+            read_ptr++;
+        }
+        const char *digit_begin = read_ptr;
+        while (read_ptr < text_end && *read_ptr >= '0' && *read_ptr <= '9')
+        {
+            read_ptr++;
+        }
+        if (read_ptr == digit_begin)
+        {
+            return false;
+        }
+        while (read_ptr < text_end && (*read_ptr == ' ' || *read_ptr == '\t' || *read_ptr == '\r'))
+        {
+            read_ptr++;
+        }
+        return read_ptr == text_end || *read_ptr == '\n';
+    }
+
+    /**
+     * @brief
+     * The function estimates the number of data lines in [read_ptr, text_end) from the size of the text and
+     * the average length of the lines at its beginning, so the vectors are reserved once when there is no count line.
+     * The estimate is a little larger than the average to avoid a reallocation when the later lines are longer.
+     *
+     * @param[in] read_ptr The beginning of the data lines.
+     * @param[in] text_end The end of the text.
+     * @return size_t
+     */
+    static size_t estimate_num_pairs(const char *read_ptr, const char *text_end)
+    {
+        size_t text_bytes = static_cast<size_t>(text_end - read_ptr);
+        size_t sample_bytes = std::min(text_bytes, estimate_sample_bytes);
+        size_t num_sample_lines = static_cast<size_t>(std::count(read_ptr, read_ptr + sample_bytes, '\n'));
+        size_t bytes_per_line = std::max<size_t>(sample_bytes / std::max<size_t>(num_sample_lines, 1), 1);
+        size_t num_lines = text_bytes / bytes_per_line + 1;
+        return num_lines + num_lines / 16;
+    }
+
+    /**
+     * @brief The number of bytes at the beginning of the data lines sampled by estimate_num_pairs().
+     *
+     */
+    static constexpr size_t estimate_sample_bytes = size_t(64) << 10;
+
+    /**
+     * @brief
+     * The function parses num_pairs pairs of numbers starting at read_ptr into the output arrays.
+     * It throws a runtime exception if a number cannot be parsed.
+     *
+     * @param[in] read_ptr The position the first number starts at, separators before it are skipped.
+     * @param[in] text_end The end of the text.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] first_pair Index of the first pair in the file, used for the error message.
+     * @param[in] num_pairs The number of pairs to be parsed.
+     * @param[out] out_one The array that stores the first numbers of the pairs.
+     * @param[out] out_two The array that stores the second numbers of the pairs.
+     * @param[out] data_stats Statistics the parsed pairs are added to, not computed if it is null.
+     * @return const char* The position right after the last parsed number.
+     */
+    static const char *parse_pairs(
+        const char *read_ptr,
+        const char *text_end,
+        const std::string &file_name,
+        const size_t first_pair,
+        const size_t num_pairs,
+        double *out_one,
+        double *out_two,
+        DATA_STATS *data_stats = nullptr)
+    {
+        for (size_t iter = 0; iter < num_pairs; iter++)
+        {
+            read_ptr = parse_number(read_ptr, text_end, out_one[iter], file_name, first_pair + iter);
+            read_ptr = parse_number(read_ptr, text_end, out_two[iter], file_name, first_pair + iter);
+            if (data_stats != nullptr)
+            {
+                data_stats->add(out_one[iter], out_two[iter]);
+            }
+        }
+        return read_ptr;
+    }
+
+    /**
+     * @brief
+     * The function skips separators and parses a number with std::from_chars.
+     * A leading '+' is accepted as std::ifstream does.
+     * It throws a runtime exception if the number cannot be parsed.
+     *
+     * @param[in] read_ptr The position to start from.
+     * @param[in] text_end The end of the text.
+     * @param[out] value The parsed number.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] pair_index Index of the data point, used for the error message.
+     * @return const char* The position right after the number.
+     */
+    static const char *parse_number(const char *read_ptr, const char *text_end, double &value,
+                                    const std::string &file_name, const size_t pair_index)
+    {
+        const char *end_ptr = try_parse_number(read_ptr, text_end, value);
+        if (end_ptr == nullptr)
+        {
+            throw_parse_error(file_name, pair_index);
+        }
+        return end_ptr;
+    }
+
+    /**
+     * @brief
+     * The function parses pairs of numbers in [read_ptr, text_end) and appends them to the output vectors.
+     *
+     * @param[in] read_ptr The position the first number starts at, separators before it are skipped.
+     * @param[in] text_end The end of the text.
+     * @param[out] out_one The vector that stores the first numbers of the pairs.
+     * @param[out] out_two The vector that stores the second numbers of the pairs.
+     * @param[out] data_stats Statistics the parsed pairs are added to, not computed if it is null.
+     * @return size_t Index of the pair failed to be parsed, std::string::npos if every pair is parsed.
+     */
+    static size_t parse_pairs_until(const char *read_ptr, const char *text_end, std::vector<double> &out_one, std::vector<double> &out_two,
+                                    DATA_STATS *data_stats = nullptr)
+    {
+        size_t expected_pairs = estimate_num_pairs(read_ptr, text_end);
+        out_one.reserve(expected_pairs);
+        out_two.reserve(expected_pairs);
+
+        double value_one = 0;
+        double value_two = 0;
+        while (true)
+        {
+            read_ptr = skip_separator(read_ptr, text_end);
+            if (read_ptr == text_end)
+            {
+                return std::string::npos;
+            }
+            read_ptr = try_parse_number(read_ptr, text_end, value_one);
+            read_ptr = (read_ptr == nullptr) ? nullptr : try_parse_number(read_ptr, text_end, value_two);
+            if (read_ptr == nullptr)
+            {
+                return out_one.size();
+            }
+            out_one.push_back(value_one);
+            out_two.push_back(value_two);
+            if (data_stats != nullptr)
+            {
+                data_stats->add(value_one, value_two);
+            }
+        }
+    }
+
+    /**
+     * @brief
+     * The function skips separators and parses a number with std::from_chars.
+     * A leading '+' is accepted as std::ifstream does.
+     *
+     * @param[in] read_ptr The position to start from.
+     * @param[in] text_end The end of the text.
+     * @param[out] value The parsed number.
+     * @return const char* The position right after the number, nullptr if the number cannot be parsed.
+     */
+    static const char *try_parse_number(const char *read_ptr, const char *text_end, double &value)
+    {
+        read_ptr = skip_separator(read_ptr, text_end);
+        if (read_ptr < text_end && *read_ptr == '+')
+        {
+            read_ptr++;
+        }
+        auto [end_ptr, error_code] = std::from_chars(read_ptr, text_end, value);
+        return (error_code == std::errc()) ? end_ptr : nullptr;
+    }
+
+    /**
+     * @brief The function throws a runtime exception for a data point that cannot be parsed.
+     *
+     * @param[in] file_name Path to the file, used for the error message.
+     * @param[in] pair_index Index of the data point.
+     */
+    [[noreturn]] static void throw_parse_error(const std::string &file_name, const size_t pair_index)
+    {
+        std::string error_message =
+            "READ ERROR - FAILED TO PARSE A NUMBER.\n"
+            "Data point " + std::to_string(pair_index + 1) + " of " + file_name + " is missing or not a number.\n";
+        throw std::runtime_error(error_message);
+    }
+
+    /**
+     * @brief The function skips spaces, tabs, line breaks and commas.
+     *
+     * @param[in] read_ptr The position to start from.
+     * @param[in] text_end The end of the text.
+     * @return const char* The position of the first character that is not a separator.
+     */
+    static const char *skip_separator(const char *read_ptr, const char *text_end)
+    {
+        while (read_ptr < text_end &&
+               (*read_ptr == ' ' || *read_ptr == '\n' || *read_ptr == ',' || *read_ptr == '\r' || *read_ptr == '\t'))
+        {
+            read_ptr++;
+        }
+        return read_ptr;
+    }
+
+    /**
+     * @brief
+     * The function validates the header of .dbin file and
+     * throws a runtime exception if the file cannot be used as arrays of double on this machine.
+     *
+     * @param[in] dbin_header The header read from the file.
+     * @param[in] file_size The size of the file in bytes.
+     * @param[in] file_name Path to the file, used for the error message.
+     */
+    static void validate_dbin_header(const DBIN_HEADER &dbin_header, const size_t file_size, const std::string &file_name)
+    {
+        const DBIN_HEADER expected_header;
+        if (std::memcmp(dbin_header.magic, expected_header.magic, sizeof(expected_header.magic)) != 0)
+        {
+            throw_dbin_error(file_name, "The file does not start with the .dbin magic number.");
+        }
+        if (dbin_header.endian_tag != expected_header.endian_tag)
+        {
+            throw_dbin_error(file_name, "The file is written on a machine of the other byte order.");
+        }
+        if (dbin_header.version != expected_header.version)
+        {
+            throw_dbin_error(file_name, "Version " + std::to_string(dbin_header.version) + " is not supported.");
+        }
+        if (dbin_header.dtype != static_cast<uint32_t>(DBIN_DTYPE::FLOAT64))
+        {
+            throw_dbin_error(file_name, "Data type " + std::to_string(dbin_header.dtype) + " is not supported.");
+        }
+
+        uint64_t column_bytes = dbin_header.num_data_points * sizeof(double);
+        bool is_aligned = (dbin_header.x_offset % alignof(double) == 0) && (dbin_header.y_offset % alignof(double) == 0);
+        bool is_inside = dbin_header.num_data_points <= file_size / sizeof(double) &&
+                         dbin_header.x_offset <= file_size && column_bytes <= file_size - dbin_header.x_offset &&
+                         dbin_header.y_offset <= file_size && column_bytes <= file_size - dbin_header.y_offset;
+        if (is_aligned == false || is_inside == false)
+        {
+            throw_dbin_error(file_name, "The columns are not aligned or exceed the end of the file.");
+        }
+    }
+
+    /**
+     * @brief
+     * The function reads the statistics footer of .dbin file and
+     * throws a runtime exception if it exceeds the end of the file or does not match the columns.
+     *
+     * @param[in] dbin_header The validated header of the file.
+     * @param[in] file_text The mapped file.
+     * @param[in] file_name Path to the file, used for the error message.
+     * @return std::shared_ptr<const BLOCK_STATS> The statistics, or null if the file has no footer.
+     */
+    static std::shared_ptr<const BLOCK_STATS> read_dbin_stats(const DBIN_HEADER &dbin_header, std::string_view file_text, const std::string &file_name)
+    {
+        if (dbin_header.stats_offset == 0)
+        {
+            return nullptr;
+        }
+        const uint64_t file_size = file_text.size();
+        const uint64_t block_points = dbin_header.stats_block_points;
+        uint64_t num_blocks = (block_points == 0) ? 0 : (dbin_header.num_data_points + block_points - 1) / block_points;
+        bool is_inside = block_points != 0 && dbin_header.stats_offset % alignof(DATA_STATS) == 0 &&
+                         dbin_header.stats_offset <= file_size &&
+                         num_blocks < (file_size - dbin_header.stats_offset) / sizeof(DATA_STATS);
+        if (is_inside == false)
+        {
+            throw_dbin_error(file_name, "The statistics footer is not aligned or exceeds the end of the file.");
+        }
+
+        auto block_stats = std::make_shared<BLOCK_STATS>();
+        block_stats->block_points = block_points;
+        block_stats->blocks.resize(static_cast<size_t>(num_blocks));
+        const char *stats_data = file_text.data() + dbin_header.stats_offset;
+        std::memcpy(&block_stats->total, stats_data, sizeof(DATA_STATS));
+        std::memcpy(block_stats->blocks.data(), stats_data + sizeof(DATA_STATS), block_stats->blocks.size() * sizeof(DATA_STATS));
+        if (block_stats->total.num_points != dbin_header.num_data_points)
+        {
+            throw_dbin_error(file_name, "The statistics footer does not match the number of data points.");
+        }
+        return block_stats;
+    }
+
+    /**
+     * @brief The function throws a runtime exception for an invalid .dbin file.
+     *
+     * @param[in] file_name Path to the file.
+     * @param[in] reason The reason the file is invalid.
+     */
+    [[noreturn]] static void throw_dbin_error(const std::string &file_name, const std::string &reason)
+    {
+        std::string error_message =
+            "READ ERROR - INVALID BINARY FILE.\n"
+            "Cannot load " + file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+
+    /**
+     * @brief
+     *  The function validates the existence of the received path and
+     *  throws a "runtime exception" if the path does not exist.
+     *  The standard input (standard_stream_name) always exists.
+     *
+     * @param[in] file_name The path to the targeted file.
+     */
+    void validate_target_is_exist(const std::string &file_name)
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            return;
+        }
+        std::filesystem::path file_path(file_name);
+        if (std::filesystem::exists(file_path) == false)
+        {
+            std::string error_message =
+                "READ ERROR - FILE DOES NOT EXIST.\n"
+                "There is no such file exists at the given path.\n"
+                "Received path - " + file_name + "\n";
+            throw std::invalid_argument(error_message);
+        }
+    }
+
+    /**
+     * @brief
+     *  The function validates the targeted path is a file and
+     *  throws a "runtime exception" if the path is not a file.
+     *  The standard input (standard_stream_name) is read as a file.
+     *
+     * @param[in] file_name The path to the targeted file.
+     */
+    void validate_target_is_file(const std::string &file_name)
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            return;
+        }
+        std::filesystem::path file_path(file_name);
+        if (std::filesystem::is_regular_file(file_path) == false)
+        {
+            std::string error_message =
+                "READ ERROR - INCORRECT INPUT.\n"
+                "Input needs to be path to a file\n"
+                "But the given path - " + file_name + " - is not a file.\n";
+            throw std::invalid_argument(error_message);
+        }
+    }
+
+    /**
+     * @brief
+     * The function validates the file format is correct and 
+     * throws a "runtime exception" if the format is not supported.
+     * The standard input (standard_stream_name) has no extension, and its format is chosen by the caller.
+     *
+     * @param[in] file_name The path to the targeted file.
+     * @param[in] target_format The required file format.
+     */
+    void validate_target_format(const std::string file_name, const std::string target_format)
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            return;
+        }
         std::filesystem::path file_path(file_name);
         if (file_path.extension() != target_format)
         {
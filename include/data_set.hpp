@@ -0,0 +1,315 @@
+#pragma once
+#include "PCH.hpp"
+#include "data_stats.hpp"
+#include <memory>
+#include <span>
+
+/**
+ * @class DATA_SET
+ * @brief
+ * DATA_SET class is a reference-counted, immutable collection of observed data points.
+ *
+ * @details
+ * DATA_SET class holds independent variables (X-Axis) and dependent variables (Y-Axis) of observed data,
+ * and hands out read-only std::span views of them.
+ * Copying DATA_SET object copies a reference, not the data; therefore,
+ * the same data can be shared by regression, detection and plotting classes without copying it.
+ * The data is released when the last DATA_SET object referring to it is destroyed.
+ *
+ * The storage is type-erased by a shared owner so that the data can live in
+ * std::vector or in any other memory (e.g. memory-mapped file) that outlives the views.
+ * Statistics of the data stored with it, e.g. in the footer of .dbin file, can be attached so that
+ * the regression and the plot use them instead of scanning the data.
+ */
+class DATA_SET
+{
+public:
+    /**
+     * @brief Constructs an empty DATA_SET object.
+     *
+     */
+    DATA_SET() {}
+
+    /**
+     * @brief Constructs a new DATA_SET object by taking ownership of the given vectors without copying them.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
+     */
+    DATA_SET(std::vector<double> &&x_observed, std::vector<double> &&y_observed)
+    {
+        validate_length_match(x_observed.size(), y_observed.size());
+        auto storage = std::make_shared<VECTOR_STORAGE>(std::move(x_observed), std::move(y_observed));
+        this->m_x_observed = storage->x_observed;
+        this->m_y_observed = storage->y_observed;
+        this->m_owner = std::move(storage);
+    }
+
+    /**
+     * @brief
+     * Constructs a new DATA_SET object by taking ownership of the given vectors without copying them,
+     * with the statistics of exactly these data points.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
+     * @param[in] block_stats Statistics of the data points, it can be null.
+     */
+    DATA_SET(std::vector<double> &&x_observed, std::vector<double> &&y_observed, std::shared_ptr<const BLOCK_STATS> block_stats)
+        : DATA_SET(std::move(x_observed), std::move(y_observed))
+    {
+        this->m_stats = std::move(block_stats);
+    }
+
+    /**
+     * @brief Constructs a new DATA_SET object by copying the given vectors once.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
+     */
+    DATA_SET(const std::vector<double> &x_observed, const std::vector<double> &y_observed)
+        : DATA_SET(std::vector<double>(x_observed), std::vector<double>(y_observed))
+    {
+    }
+
+    /**
+     * @brief
+     * Constructs a new DATA_SET object that refers to memory kept alive by the given owner.
+     *
+     * @param[in] owner An object that keeps the memory of the views alive.
+     * @param[in] x_observed A view of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A view of observed data's dependent variables (Y-Axis).
+     */
+    DATA_SET(std::shared_ptr<const void> owner, std::span<const double> x_observed, std::span<const double> y_observed)
+        : m_owner(std::move(owner)), m_x_observed(x_observed), m_y_observed(y_observed)
+    {
+        validate_length_match(x_observed.size(), y_observed.size());
+    }
+
+    /**
+     * @brief
+     * Constructs a new DATA_SET object that refers to memory kept alive by the given owner,
+     * with the statistics of exactly these data points.
+     *
+     * @param[in] owner An object that keeps the memory of the views alive.
+     * @param[in] x_observed A view of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A view of observed data's dependent variables (Y-Axis).
+     * @param[in] block_stats Statistics of the data points, it can be null.
+     */
+    DATA_SET(std::shared_ptr<const void> owner, std::span<const double> x_observed, std::span<const double> y_observed,
+             std::shared_ptr<const BLOCK_STATS> block_stats)
+        : DATA_SET(std::move(owner), x_observed, y_observed)
+    {
+        this->m_stats = std::move(block_stats);
+    }
+
+    ~DATA_SET() {}
+
+    /**
+     * @brief Gets the read-only view of observed data's independent variables (X-Axis).
+     *
+     * @return std::span<const double>
+     */
+    std::span<const double> get_x() const
+    {
+        return this->m_x_observed;
+    }
+
+    /**
+     * @brief Gets the read-only view of observed data's dependent variables (Y-Axis).
+     *
+     * @return std::span<const double>
+     */
+    std::span<const double> get_y() const
+    {
+        return this->m_y_observed;
+    }
+
+    /**
+     * @brief Gets the number of data points.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return this->m_x_observed.size();
+    }
+
+    /**
+     * @brief Checks the DATA_SET object has no data points.
+     *
+     * @return true
+     * @return false
+     */
+    bool empty() const
+    {
+        return this->m_x_observed.empty();
+    }
+
+    /**
+     * @brief Gets the statistics stored with the data points.
+     *
+     * @return const BLOCK_STATS* The statistics, or null if they are not known and the data must be scanned.
+     */
+    const BLOCK_STATS *get_stats() const
+    {
+        return this->m_stats.get();
+    }
+
+    /**
+     * @brief
+     * Selects the data points whose independent variable (X-Axis) lies in [x_low, x_high].
+     * @details
+     * With the statistics of the blocks, e.g. loaded from .dbin file, the blocks whose range of X-Axis does not
+     * overlap [x_low, x_high] are skipped without reading them, and the blocks whose range lies inside it are
+     * selected as a whole; only the data points of the blocks crossing a bound are compared with the bounds.
+     * For sorted data such as a time series, these are the two blocks at the ends of the window.
+     * If the data has statistics, the returned object carries the statistics of the selected data points as a whole,
+     * merged from the blocks inside the window and accumulated from the points read, so the regression and
+     * the plot of the window start without another pass over it.
+     * If the selected data points are consecutive, the returned object shares them without copying;
+     * otherwise, they are copied in order.
+     *
+     * @param[in] x_low The lowest independent variable selected.
+     * @param[in] x_high The highest independent variable selected.
+     * @return DATA_SET The selected data points, empty if there is none.
+     */
+    DATA_SET select_x_range(const double x_low, const double x_high) const
+    {
+        const bool has_blocks = (this->m_stats != nullptr && this->m_stats->blocks.empty() == false);
+        const size_t block_points = (has_blocks == true) ? static_cast<size_t>(this->m_stats->block_points)
+                                                         : std::max<size_t>(this->size(), 1);
+        auto is_block_skipped = [&](size_t block_index)
+        {
+            if (has_blocks == false)
+            {
+                return false;
+            }
+            const DATA_STATS &block_stats = this->m_stats->blocks[block_index];
+            return block_stats.x_max < x_low || block_stats.x_min > x_high;
+        };
+        auto is_block_inside = [&](size_t block_index)
+        {
+            if (has_blocks == false)
+            {
+                return false;
+            }
+            const DATA_STATS &block_stats = this->m_stats->blocks[block_index];
+            return block_stats.x_min >= x_low && block_stats.x_max <= x_high;
+        };
+        // select_block(block_begin, block_end, block_index) is called for a whole block inside the window,
+        // select_point(point_index) for each selected data point of a block crossing a bound
+        auto for_each_selected = [&](auto &&select_block, auto &&select_point)
+        {
+            for (size_t block_begin = 0; block_begin < this->size(); block_begin += block_points)
+            {
+                size_t block_index = block_begin / block_points;
+                if (is_block_skipped(block_index) == true)
+                {
+                    continue;
+                }
+                size_t block_end = std::min(block_begin + block_points, this->size());
+                if (is_block_inside(block_index) == true)
+                {
+                    select_block(block_begin, block_end, block_index);
+                    continue;
+                }
+                for (size_t iter = block_begin; iter < block_end; iter++)
+                {
+                    if (this->m_x_observed[iter] >= x_low && this->m_x_observed[iter] <= x_high)
+                    {
+                        select_point(iter);
+                    }
+                }
+            }
+        };
+
+        size_t first_point = 0;
+        size_t num_selected = 0;
+        size_t last_point = 0;
+        DATA_STATS selected_stats;
+        for_each_selected([&](size_t block_begin, size_t block_end, size_t block_index)
+                          {
+                              first_point = (num_selected == 0) ? block_begin : first_point;
+                              last_point = block_end - 1;
+                              num_selected += block_end - block_begin;
+                              selected_stats.merge(this->m_stats->blocks[block_index]); },
+                          [&](size_t point_index)
+                          {
+                              first_point = (num_selected == 0) ? point_index : first_point;
+                              last_point = point_index;
+                              num_selected++;
+                              if (this->m_stats != nullptr)
+                              {
+                                  selected_stats.add(this->m_x_observed[point_index], this->m_y_observed[point_index]);
+                              } });
+        if (num_selected == 0)
+        {
+            return DATA_SET();
+        }
+        std::shared_ptr<const BLOCK_STATS> block_stats;
+        if (this->m_stats != nullptr)
+        {
+            // the window does not start at a block boundary, so only the statistics of the whole window are kept
+            auto window_stats = std::make_shared<BLOCK_STATS>();
+            window_stats->total = selected_stats;
+            block_stats = std::move(window_stats);
+        }
+        if (last_point - first_point + 1 == num_selected)
+        {
+            return DATA_SET(this->m_owner, this->m_x_observed.subspan(first_point, num_selected),
+                            this->m_y_observed.subspan(first_point, num_selected), std::move(block_stats));
+        }
+
+        std::vector<double> x_selected;
+        std::vector<double> y_selected;
+        x_selected.reserve(num_selected);
+        y_selected.reserve(num_selected);
+        for_each_selected([&](size_t block_begin, size_t block_end, size_t)
+                          {
+                              x_selected.insert(x_selected.end(), this->m_x_observed.begin() + block_begin, this->m_x_observed.begin() + block_end);
+                              y_selected.insert(y_selected.end(), this->m_y_observed.begin() + block_begin, this->m_y_observed.begin() + block_end); },
+                          [&](size_t point_index)
+                          {
+                              x_selected.push_back(this->m_x_observed[point_index]);
+                              y_selected.push_back(this->m_y_observed[point_index]); });
+        return DATA_SET(std::move(x_selected), std::move(y_selected), std::move(block_stats));
+    }
+
+private:
+    /**
+     * @brief Storage of the data points when DATA_SET object takes ownership of vectors.
+     *
+     */
+    struct VECTOR_STORAGE
+    {
+        VECTOR_STORAGE(std::vector<double> &&x, std::vector<double> &&y) : x_observed(std::move(x)), y_observed(std::move(y)) {}
+        std::vector<double> x_observed;
+        std::vector<double> y_observed;
+    };
+
+    std::shared_ptr<const void> m_owner;
+    std::span<const double> m_x_observed;
+    std::span<const double> m_y_observed;
+    std::shared_ptr<const BLOCK_STATS> m_stats;
+
+    /**
+     * @brief
+     * The function validates the number of independent and dependent variables matches each other and
+     * throws runtime error if there is a mismatch.
+     *
+     * @param[in] x_len The number of independent variables.
+     * @param[in] y_len The number of dependent variables.
+     */
+    void validate_length_match(const size_t x_len, const size_t y_len)
+    {
+        if (x_len != y_len)
+        {
+            std::string error_message =
+                "DATA SET ERROR - VECTOR LENGTH MISMATCH\n"
+                "Number of elements in given vector must be matched, but\n"
+                "X-data: " + std::to_string(x_len) + "\n"
+                "Y-data: " + std::to_string(y_len) + "\n";
+            throw std::runtime_error(error_message);
+        }
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+#include "PCH.hpp"
+#include <limits>
+#include <span>
+
+/**
+ * @brief
+ * Sufficient statistics of observed data: the number of data points, the sums required by
+ * ordinary least square regression and the means, and the range of the data.
+ * Statistics of two parts of the same data are combined with merge() without reading the data again.
+ */
+struct DATA_STATS
+{
+    uint64_t num_points = 0;
+    double x_sum = 0.0;
+    double y_sum = 0.0;
+    double xx_sum = 0.0;
+    double yy_sum = 0.0;
+    double xy_sum = 0.0;
+    double x_min = std::numeric_limits<double>::infinity();
+    double x_max = -std::numeric_limits<double>::infinity();
+    double y_min = std::numeric_limits<double>::infinity();
+    double y_max = -std::numeric_limits<double>::infinity();
+
+    /**
+     * @brief Adds the data points of the given views, in order, to the statistics.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis), of the same length.
+     */
+    void accumulate(std::span<const double> x_observed, std::span<const double> y_observed)
+    {
+        for (size_t iter = 0; iter < x_observed.size(); iter++)
+        {
+            add(x_observed[iter], y_observed[iter]);
+        }
+    }
+
+    /**
+     * @brief Adds a data point to the statistics, used by the loaders while the data points are parsed.
+     *
+     * @param[in] x The independent variable (X-Axis) of the data point.
+     * @param[in] y The dependent variable (Y-Axis) of the data point.
+     */
+    void add(const double x, const double y)
+    {
+        num_points++;
+        x_sum += x;
+        y_sum += y;
+        xx_sum += x * x;
+        yy_sum += y * y;
+        xy_sum += x * y;
+        x_min = x_min < x ? x_min : x;
+        x_max = x_max > x ? x_max : x;
+        y_min = y_min < y ? y_min : y;
+        y_max = y_max > y ? y_max : y;
+    }
+
+    /**
+     * @brief Adds the statistics of another part of the same data, used to combine the statistics of blocks.
+     *
+     * @param[in] other Statistics of another part of the data.
+     */
+    void merge(const DATA_STATS &other)
+    {
+        num_points += other.num_points;
+        x_sum += other.x_sum;
+        y_sum += other.y_sum;
+        xx_sum += other.xx_sum;
+        yy_sum += other.yy_sum;
+        xy_sum += other.xy_sum;
+        x_min = x_min < other.x_min ? x_min : other.x_min;
+        x_max = x_max > other.x_max ? x_max : other.x_max;
+        y_min = y_min < other.y_min ? y_min : other.y_min;
+        y_max = y_max > other.y_max ? y_max : other.y_max;
+    }
+};
+static_assert(sizeof(DATA_STATS) == 80, "DATA_STATS is stored in .dbin files and must be 80 bytes");
+
+/**
+ * @brief
+ * Statistics of a DATA_SET object as a whole and of its consecutive blocks of block_points data points;
+ * the last block may be shorter.
+ * The statistics of a range of blocks are merged from the blocks without reading the data.
+ * When only the statistics of the whole data are known, e.g. accumulated while a text file is parsed,
+ * block_points is 0 and there is no block.
+ */
+struct BLOCK_STATS
+{
+    DATA_STATS total;
+    uint64_t block_points = 0;
+    std::vector<DATA_STATS> blocks;
+
+    /**
+     * @brief Computes the statistics of the given data points block by block in a single pass.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis), of the same length.
+     * @param[in] block_points The number of data points in a block, larger than zero.
+     * @return BLOCK_STATS
+     */
+    static BLOCK_STATS compute(std::span<const double> x_observed, std::span<const double> y_observed, const uint64_t block_points)
+    {
+        BLOCK_STATS block_stats;
+        block_stats.block_points = block_points;
+        for (size_t block_begin = 0; block_begin < x_observed.size(); block_begin += block_points)
+        {
+            size_t block_size = std::min(static_cast<size_t>(block_points), x_observed.size() - block_begin);
+            DATA_STATS data_stats;
+            data_stats.accumulate(x_observed.subspan(block_begin, block_size), y_observed.subspan(block_begin, block_size));
+            block_stats.total.merge(data_stats);
+            block_stats.blocks.push_back(data_stats);
+        }
+        return block_stats;
+    }
+
+    /**
+     * @brief Merges the statistics of blocks [first_block, last_block).
+     *
+     * @param[in] first_block Index of the first block.
+     * @param[in] last_block Index after the last block, at most the number of blocks.
+     * @return DATA_STATS
+     */
+    DATA_STATS merge_blocks(const size_t first_block, const size_t last_block) const
+    {
+        DATA_STATS data_stats;
+        for (size_t iter = first_block; iter < last_block; iter++)
+        {
+            data_stats.merge(this->blocks[iter]);
+        }
+        return data_stats;
+    }
+};
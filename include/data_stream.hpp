@@ -0,0 +1,485 @@
+/**
+ * The file contains the streaming reader of data files that reads a file block by block.
+ */
+#pragma once
+#include "data_read.hpp"
+#include "compressed_file.hpp"
+#include <iterator>
+
+/**
+ * @brief
+ * DATA_BLOCK structure is a block of consecutive data points read by DATA_STREAM.
+ * The views refer to the buffers of DATA_STREAM and are valid until the next block is read.
+ *
+ */
+struct DATA_BLOCK
+{
+    size_t first_point = 0;           // index of the first data point of the block in the file
+    std::span<const double> x_block;  // independent variables (X-Axis) of the block
+    std::span<const double> y_block;  // dependent variables (Y-Axis) of the block
+
+    /**
+     * @brief Gets the number of data points in the block.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return this->x_block.size();
+    }
+};
+
+/**
+ * @class DATA_STREAM
+ * @brief
+ * DATA_STREAM class reads .dvec, .csv or .dbin format file in blocks of a fixed number of data points.
+ * .dvec and .csv files compressed with gzip (.dvec.gz) or zstd (.dvec.zst) are decompressed on another thread
+ * while the blocks are parsed.
+ *
+ * @details
+ * Only a block of data points and a buffer of the text are kept in memory; therefore,
+ * a file larger than the memory can be processed block by block.
+ * The blocks are read with read_block() or with a range-based for loop:
+ *
+ *     DATA_STREAM data_stream("observed_data.dvec");
+ *     for (const DATA_BLOCK &data_block : data_stream) { ... }
+ *
+ * Every loop starts again from the first data point, so multi-pass algorithms can read the file more than once;
+ * rewind() does the same for read_block().
+ * Text files are parsed with std::from_chars as IO_MODE::MAPPED does, and each line must hold a single data point.
+ * A text file without the count line is read until the end of the file.
+ * It throws a runtime exception with the index of the data point if a number cannot be parsed or
+ * the file ends before the number of data points in the count line.
+ * DATA_STREAM class uses DATA_READ class with has-a relation for validation and parsing.
+ */
+class DATA_STREAM
+{
+public:
+    /**
+     * @brief The number of data points in a block if it is not given.
+     *
+     */
+    static constexpr size_t default_block_size = size_t(1) << 16;
+
+    /**
+     * @brief The number of data points of a text file without the count line until the end of the file is reached.
+     *
+     */
+    static constexpr size_t unknown_num_data_points = SIZE_MAX;
+
+    /**
+     * @class iterator
+     * @brief Input iterator over the blocks of DATA_STREAM, used by range-based for loops.
+     *
+     */
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = DATA_BLOCK;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const DATA_BLOCK *;
+        using reference = const DATA_BLOCK &;
+
+        iterator() {}
+        explicit iterator(DATA_STREAM *data_stream) : m_stream(data_stream) {}
+
+        reference operator*() const
+        {
+            return this->m_stream->m_block;
+        }
+
+        pointer operator->() const
+        {
+            return &this->m_stream->m_block;
+        }
+
+        iterator &operator++()
+        {
+            if (this->m_stream->read_block(this->m_stream->m_block) == false)
+            {
+                this->m_stream = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++(*this);
+        }
+
+        bool operator==(const iterator &other) const
+        {
+            return this->m_stream == other.m_stream;
+        }
+
+    private:
+        DATA_STREAM *m_stream = nullptr;
+    };
+
+    /**
+     * @brief
+     * Constructs a new DATA_STREAM object and reads the header of the file.
+     * It throws an exception if the file does not exist, is not .dvec, .csv, .dbin, .dvec.gz, .csv.gz,
+     * .dvec.zst or .csv.zst format, or has an invalid header.
+     *
+     * @param[in] file_name Path to the file that will be read.
+     * @param[in] block_size The number of data points in a block, zero means default_block_size.
+     */
+    explicit DATA_STREAM(const std::string &file_name, const size_t block_size = 0)
+        : m_file_name(file_name), m_block_size((block_size == 0) ? default_block_size : block_size)
+    {
+        this->m_reader.validate_target_is_exist(file_name);
+        this->m_reader.validate_target_is_file(file_name);
+        this->m_compression = get_compression(file_name);
+        std::filesystem::path data_path = remove_compression_extension(file_name);
+        this->m_is_binary = (data_path.extension() == ".dbin" && this->m_compression == COMPRESSION::NONE);
+        if (this->m_is_binary == false && data_path.extension() != ".csv")
+        {
+            this->m_reader.validate_target_format(data_path.string(), ".dvec");
+        }
+
+        if (this->m_compression == COMPRESSION::NONE)
+        {
+            this->m_file.open(file_name, std::ios::in | std::ios::binary);
+            this->m_reader.validate_file_is_opened(this->m_file, file_name);
+        }
+        else
+        {
+            validate_compression_supported(file_name, "READ ERROR");
+        }
+        if (this->m_is_binary == true)
+        {
+            this->read_binary_header();
+        }
+        this->m_text.resize(initial_text_bytes);
+        this->rewind();
+    }
+
+    ~DATA_STREAM() {}
+
+    DATA_STREAM(const DATA_STREAM &) = delete;
+    DATA_STREAM &operator=(const DATA_STREAM &) = delete;
+
+    /**
+     * @brief
+     * Gets the number of data points in the file.
+     * It is unknown_num_data_points for a text file without the count line until the last block has been read.
+     *
+     * @return size_t
+     */
+    size_t get_num_data_points() const
+    {
+        return this->m_num_data_points;
+    }
+
+    /**
+     * @brief Gets the number of data points in a block.
+     *
+     * @return size_t
+     */
+    size_t get_block_size() const
+    {
+        return this->m_block_size;
+    }
+
+    /**
+     * @brief Starts reading again from the first data point; a compressed file is decompressed again.
+     *
+     */
+    void rewind()
+    {
+        this->m_num_read = 0;
+        if (this->m_is_binary == true)
+        {
+            this->m_is_at_first_point = true;
+            return;
+        }
+        if (this->m_compression == COMPRESSION::NONE)
+        {
+            this->m_file.clear();
+            this->m_file.seekg(0);
+        }
+        else
+        {
+            this->m_decompress_stream.reset();
+            this->m_decompress_stream = std::make_unique<DECOMPRESS_STREAM>(this->m_file_name);
+        }
+        this->m_text_size = 0;
+        this->m_parse_begin = 0;
+        this->m_parse_end = 0;
+        this->read_text_header();
+        this->m_is_at_first_point = true;
+    }
+
+    /**
+     * @brief
+     * Reads the next block of data points.
+     * The last block may be smaller than the block size.
+     *
+     * @param[out] data_block The block read; its views are valid until the next block is read.
+     * @return true When a block is read.
+     * @return false When every data point has been read.
+     */
+    bool read_block(DATA_BLOCK &data_block)
+    {
+        size_t num_points = std::min(this->m_block_size, this->m_num_data_points - this->m_num_read);
+        if (num_points == 0)
+        {
+            return false;
+        }
+        this->m_is_at_first_point = false;
+        this->m_x_block.resize(num_points);
+        this->m_y_block.resize(num_points);
+        if (this->m_is_binary == true)
+        {
+            this->read_binary_block(num_points);
+        }
+        else
+        {
+            num_points = this->read_text_block(num_points);
+            if (num_points == 0)
+            {
+                return false;
+            }
+        }
+
+        data_block.first_point = this->m_num_read;
+        data_block.x_block = std::span<const double>(this->m_x_block.data(), num_points);
+        data_block.y_block = std::span<const double>(this->m_y_block.data(), num_points);
+        this->m_num_read += num_points;
+        return true;
+    }
+
+    /**
+     * @brief Starts reading from the first data point and returns the iterator at the first block.
+     *
+     * @return iterator
+     */
+    iterator begin()
+    {
+        if (this->m_is_at_first_point == false)
+        {
+            this->rewind();
+        }
+        iterator block_iter(this);
+        return ++block_iter;
+    }
+
+    /**
+     * @brief Returns the iterator after the last block.
+     *
+     * @return iterator
+     */
+    iterator end()
+    {
+        return iterator();
+    }
+
+private:
+    static constexpr size_t initial_text_bytes = size_t(1) << 20;
+
+    DATA_READ m_reader;
+    std::string m_file_name;
+    std::ifstream m_file;
+    COMPRESSION m_compression = COMPRESSION::NONE;
+    std::unique_ptr<DECOMPRESS_STREAM> m_decompress_stream; // source of the text of a compressed file
+    size_t m_block_size = default_block_size;
+    bool m_is_binary = false;
+    size_t m_num_data_points = 0;
+    bool m_has_count = true; // false for a text file without the count line
+    size_t m_num_read = 0;
+    bool m_is_at_first_point = false; // nothing has been read since the header, so begin() does not read the file again
+    DBIN_HEADER m_dbin_header;
+
+    std::vector<double> m_x_block;
+    std::vector<double> m_y_block;
+    DATA_BLOCK m_block;
+
+    std::vector<char> m_text;   // buffer of the text read from the file
+    size_t m_text_size = 0;     // number of bytes in the buffer
+    size_t m_parse_begin = 0;   // position of the next number in the buffer
+    size_t m_parse_end = 0;     // end of the complete lines in the buffer
+
+    /**
+     * @brief
+     * Skips the comment lines starting with '%' and parses the count line of .dvec or .csv format file
+     * from the text buffer, filling it as needed.
+     * If the first line is a data line, the number of data points is unknown until the end of the file.
+     * It throws a runtime exception if neither the count nor a data point is found.
+     *
+     */
+    void read_text_header()
+    {
+        const char *read_ptr = nullptr;
+        const char *parse_end = nullptr;
+        while (true)
+        {
+            read_ptr = this->m_text.data() + this->m_parse_begin;
+            parse_end = this->m_text.data() + this->m_parse_end;
+            while (read_ptr < parse_end && *read_ptr == '%')
+            {
+                const char *line_end = static_cast<const char *>(std::memchr(read_ptr, '\n', parse_end - read_ptr));
+                read_ptr = (line_end == nullptr) ? parse_end : line_end + 1;
+            }
+            read_ptr = DATA_READ::skip_separator(read_ptr, parse_end);
+            this->m_parse_begin = static_cast<size_t>(read_ptr - this->m_text.data());
+            if (read_ptr < parse_end || this->fill_text() == false)
+            {
+                break;
+            }
+        }
+
+        if (read_ptr < parse_end && DATA_READ::is_count_line(read_ptr, parse_end) == false)
+        {
+            this->m_has_count = false;
+            this->m_num_data_points = unknown_num_data_points;
+            return;
+        }
+
+        uint32_t vec_len = 0;
+        auto [end_ptr, error_code] = std::from_chars(read_ptr, parse_end, vec_len);
+        if (error_code != std::errc())
+        {
+            std::string error_message =
+                "READ ERROR - FAILED TO PARSE A NUMBER.\n"
+                "The number of data points is expected at the beginning of " + this->m_file_name + "\n";
+            throw std::runtime_error(error_message);
+        }
+        this->m_has_count = true;
+        this->m_num_data_points = vec_len;
+        this->m_parse_begin = static_cast<size_t>(end_ptr - this->m_text.data());
+    }
+
+    /**
+     * @brief Reads the next bytes of the text from the file or from the decompression thread.
+     *
+     * @param[out] output The buffer the bytes are read into.
+     * @param[in] max_bytes The size of the buffer.
+     * @return size_t The number of bytes read, smaller than max_bytes only at the end of the file.
+     */
+    size_t read_text(char *output, const size_t max_bytes)
+    {
+        if (this->m_decompress_stream != nullptr)
+        {
+            return this->m_decompress_stream->read(output, max_bytes);
+        }
+        this->m_file.read(output, static_cast<std::streamsize>(max_bytes));
+        return static_cast<size_t>(this->m_file.gcount());
+    }
+
+    /**
+     * @brief Reads and validates the header of .dbin format file.
+     *
+     */
+    void read_binary_header()
+    {
+        std::error_code size_error;
+        size_t file_size = static_cast<size_t>(std::filesystem::file_size(this->m_file_name, size_error));
+        if (!this->m_file.read(reinterpret_cast<char *>(&this->m_dbin_header), sizeof(DBIN_HEADER)))
+        {
+            DATA_READ::throw_dbin_error(this->m_file_name, "The file is smaller than the header.");
+        }
+        DATA_READ::validate_dbin_header(this->m_dbin_header, file_size, this->m_file_name);
+        this->m_num_data_points = static_cast<size_t>(this->m_dbin_header.num_data_points);
+    }
+
+    /**
+     * @brief Reads the next num_points values of both columns of .dbin format file.
+     *
+     * @param[in] num_points The number of data points to be read.
+     */
+    void read_binary_block(const size_t num_points)
+    {
+        std::streamsize num_bytes = static_cast<std::streamsize>(num_points * sizeof(double));
+        std::streamoff point_offset = static_cast<std::streamoff>(this->m_num_read * sizeof(double));
+
+        this->m_file.seekg(static_cast<std::streamoff>(this->m_dbin_header.x_offset) + point_offset);
+        this->m_file.read(reinterpret_cast<char *>(this->m_x_block.data()), num_bytes);
+        this->m_file.seekg(static_cast<std::streamoff>(this->m_dbin_header.y_offset) + point_offset);
+        this->m_file.read(reinterpret_cast<char *>(this->m_y_block.data()), num_bytes);
+        if (!this->m_file)
+        {
+            DATA_READ::throw_dbin_error(this->m_file_name, "The file ends before the last data point.");
+        }
+    }
+
+    /**
+     * @brief
+     * Parses the next num_points data points of .dvec or .csv format file, refilling the text buffer as needed.
+     * For a file without the count line, fewer data points are parsed at the end of the file and
+     * the number of data points becomes known.
+     *
+     * @param[in] num_points The number of data points to be parsed.
+     * @return size_t The number of data points parsed.
+     */
+    size_t read_text_block(const size_t num_points)
+    {
+        size_t num_parsed = 0;
+        while (num_parsed < num_points)
+        {
+            const char *parse_begin = this->m_text.data() + this->m_parse_begin;
+            const char *parse_end = this->m_text.data() + this->m_parse_end;
+            parse_begin = DATA_READ::skip_separator(parse_begin, parse_end);
+            if (parse_begin == parse_end)
+            {
+                if (this->fill_text() == false)
+                {
+                    if (this->m_has_count == true)
+                    {
+                        DATA_READ::throw_parse_error(this->m_file_name, this->m_num_read + num_parsed);
+                    }
+                    this->m_num_data_points = this->m_num_read + num_parsed;
+                    return num_parsed;
+                }
+                continue;
+            }
+
+            const char *read_ptr = DATA_READ::try_parse_number(parse_begin, parse_end, this->m_x_block[num_parsed]);
+            read_ptr = (read_ptr == nullptr) ? nullptr : DATA_READ::try_parse_number(read_ptr, parse_end, this->m_y_block[num_parsed]);
+            if (read_ptr == nullptr)
+            {
+                DATA_READ::throw_parse_error(this->m_file_name, this->m_num_read + num_parsed);
+            }
+            this->m_parse_begin = static_cast<size_t>(read_ptr - this->m_text.data());
+            num_parsed++;
+        }
+        return num_parsed;
+    }
+
+    /**
+     * @brief
+     * Keeps the incomplete line at the end of the buffer, reads more text after it, and
+     * sets the parse range to the complete lines in the buffer.
+     * The buffer grows if a single line does not fit in it.
+     *
+     * @return true When there is text left to parse.
+     * @return false When the end of the file is reached.
+     */
+    bool fill_text()
+    {
+        size_t num_kept = this->m_text_size - this->m_parse_end;
+        std::memmove(this->m_text.data(), this->m_text.data() + this->m_parse_end, num_kept);
+        if (num_kept == this->m_text.size())
+        {
+            this->m_text.resize(this->m_text.size() * 2);
+        }
+        size_t num_new = this->read_text(this->m_text.data() + num_kept, this->m_text.size() - num_kept);
+        this->m_text_size = num_kept + num_new;
+        this->m_parse_begin = 0;
+
+        if (num_new == 0)
+        {
+            // the last line has no line break
+            this->m_parse_end = this->m_text_size;
+            return num_kept > 0;
+        }
+        const char *line_end = this->m_text.data() + this->m_text_size;
+        while (line_end > this->m_text.data() && line_end[-1] != '\n')
+        {
+            line_end--;
+        }
+        this->m_parse_end = static_cast<size_t>(line_end - this->m_text.data());
+        return true;
+    }
+};
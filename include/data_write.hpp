@@ -1,5 +1,13 @@
 #pragma once
 #include "PCH.hpp"
+#include "dbin_header.hpp"
+#include "archive_header.hpp"
+#include "data_set.hpp"
+#include "thread_pool.hpp"
+#include "compressed_file.hpp"
+#include "standard_stream.hpp"
+#include <charconv>
+#include <span>
 
 /**
  * @class WRITE_DATA
@@ -8,6 +16,14 @@
  * WRITE_DATA class supports the following data formats.
  *  .dvec - custom data format for the project, preferred when the use of a spreadsheet is not expected
  *  .csv - comma-separated variables format for users who wants to write data to be used with Excel, Matlab, or other spreadsheet-based data formats.
+ *  .dbin - binary data format for the project, preferred when the data is loaded many times
+ *  .darc - archive format for the project that holds many series of data points in a single file
+ *
+ * .dvec and .csv files are formatted with std::to_chars in the shortest form that is read back as the same double.
+ * The lines are formatted into buffers of text_buffer_bytes bytes that are reused between files and
+ * written to the file in a single call each; with a thread pool, the buffers are formatted concurrently.
+ * A file name ending with .gz or .zst, e.g. outlier_data.dvec.gz, is compressed with gzip or zstd.
+ * The file name standard_stream_name ("-") writes the data to the standard output in the format of the called method.
  *
  * Unlike READ_DATA class, WRITE_DATA class does not provide the SAFE/UNSAFE methods.
  * It provides the UNSAFE method (according to the term SAFE method used in READ_DATA class) only
@@ -29,36 +45,24 @@ public:
      *  - a collection of independent variables (X-Axis values)
      *  - a dependent variables (Y-Axis values)
      * The length of input vectors must match.
-     * For result accuracy, the type of written data's element is 'double.'
+     * For result accuracy, the type of written data's element is 'double', written without rounding.
      * Preferred when the use of a spreadsheet is not expected.
      *
      * @param[in] file_name file name to be written, it must contain file format .dvec
      * @param[in] vec_one collection of independent variables (X-Axis values) to be written
      * @param[in] vec_two collection of dependent variables (Y-Axis values) to be written
+     * @param[in] thread_pool threads formatting the lines concurrently, nullptr formats them on the calling thread
      * @return true
      * @return false
      */
-    bool write_vec(const std::string file_name, const std::vector<double> &vec_one, const std::vector<double> &vec_two)
+    bool write_vec(const std::string file_name, std::span<const double> vec_one, std::span<const double> vec_two,
+                   THREAD_POOL *thread_pool = nullptr)
     {
         validate_is_vector_empty(vec_one, file_name + "_x");
-        validate_is_vector_empty(vec_one, file_name + "_y");
+        validate_is_vector_empty(vec_two, file_name + "_y");
         validate_vector_length_match(file_name, vec_one, vec_two);
-        validate_file_format(file_name, ".dvec");
-
-        std::ofstream write_vec_file;
-        write_vec_file.open(file_name, std::ios::out);
-        validate_is_file_created(write_vec_file, file_name);
-
-        std::string output_line;
-        output_line = std::to_string(vec_one.size());
-        write_vec_file << output_line << "\n";
-
-        for (uint32_t iter = 0; iter < vec_one.size(); iter++)
-        {
-            write_vec_file << std::to_string(vec_one[iter]) << " " << std::to_string(vec_two[iter]) << "\n";
-        }
-        write_vec_file.close();
-        return true;
+        validate_file_format(remove_compression_extension(file_name).string(), ".dvec");
+        return write_text(file_name, vec_one, vec_two, " ", thread_pool);
     }
 
     /**
@@ -67,39 +71,329 @@ public:
      *  - a collection of independent variables (X-Axis values)
      *  - a dependent variables (Y-Axis values)
      * The length of input vectors must match.
-     * For result accuracy, the type of written data's element is 'double.'
+     * For result accuracy, the type of written data's element is 'double', written without rounding.
      * Preferred when the use of a spreadsheet is expected.
      *
      * @param[in] file_name file name to be written, it must contain file format .csv
      * @param[in] vec_one collection of independent variables (X-Axis values) to be written
      * @param[in] vec_two collection of dependent variables (Y-Axis values) to be written
+     * @param[in] thread_pool threads formatting the lines concurrently, nullptr formats them on the calling thread
+     * @return true
+     * @return false
+     */
+    bool write_csv(const std::string file_name, std::span<const double> vec_one, std::span<const double> vec_two,
+                   THREAD_POOL *thread_pool = nullptr)
+    {
+        validate_is_vector_empty(vec_one, file_name + "_x");
+        validate_is_vector_empty(vec_two, file_name + "_y");
+        validate_vector_length_match(file_name, vec_one, vec_two);
+        validate_file_format(remove_compression_extension(file_name).string(), ".csv");
+        return write_text(file_name, vec_one, vec_two, ", ", thread_pool);
+    }
+
+    /**
+     * @brief
+     * The function writes a .dbin file based on the received input vectors.
+     *  - a collection of independent variables (X-Axis values)
+     *  - a dependent variables (Y-Axis values)
+     * The length of input vectors must match.
+     * The values are written in binary without rounding, and the file can be loaded without parsing.
+     * The statistics of the data and of its blocks are written in the footer, so the regression and
+     * the plot of the loaded data do not scan it for the sums and the range.
+     * Preferred when the data is loaded many times.
+     *
+     * @param[in] file_name file name to be written, it must contain file format .dbin
+     * @param[in] vec_one collection of independent variables (X-Axis values) to be written
+     * @param[in] vec_two collection of dependent variables (Y-Axis values) to be written
      * @return true
      * @return false
      */
-    bool write_csv(const std::string file_name, const std::vector<double> &vec_one, const std::vector<double> &vec_two)
+    bool write_dbin(const std::string file_name, std::span<const double> vec_one, std::span<const double> vec_two)
     {
         validate_is_vector_empty(vec_one, file_name + "_x");
-        validate_is_vector_empty(vec_one, file_name + "_y");
+        validate_is_vector_empty(vec_two, file_name + "_y");
         validate_vector_length_match(file_name, vec_one, vec_two);
-        validate_file_format(file_name, ".csv");
+        validate_file_format(file_name, ".dbin");
+
+        std::ofstream write_dbin_file;
+        std::ostream &output_stream = open_output(write_dbin_file, file_name);
+
+        DBIN_HEADER dbin_header;
+        uint64_t column_bytes = DBIN_HEADER::get_column_bytes(vec_one.size());
+        dbin_header.num_data_points = vec_one.size();
+        dbin_header.x_offset = sizeof(DBIN_HEADER);
+        dbin_header.y_offset = dbin_header.x_offset + column_bytes;
+        dbin_header.stats_offset = dbin_header.y_offset + column_bytes;
+        dbin_header.stats_block_points = DBIN_HEADER::default_stats_block_points;
+        BLOCK_STATS block_stats = BLOCK_STATS::compute(vec_one, vec_two, dbin_header.stats_block_points);
+
+        const std::vector<char> column_padding(dbin_header.column_alignment, 0);
+        size_t num_padding = static_cast<size_t>(column_bytes - vec_one.size_bytes());
+        output_stream.write(reinterpret_cast<const char *>(&dbin_header), sizeof(DBIN_HEADER));
+        output_stream.write(reinterpret_cast<const char *>(vec_one.data()), vec_one.size_bytes());
+        output_stream.write(column_padding.data(), num_padding);
+        output_stream.write(reinterpret_cast<const char *>(vec_two.data()), vec_two.size_bytes());
+        output_stream.write(column_padding.data(), num_padding);
+        output_stream.write(reinterpret_cast<const char *>(&block_stats.total), sizeof(DATA_STATS));
+        output_stream.write(reinterpret_cast<const char *>(block_stats.blocks.data()), block_stats.blocks.size() * sizeof(DATA_STATS));
+        close_output(output_stream, write_dbin_file, file_name);
+        return true;
+    }
 
-        std::ofstream write_vec_file;
-        write_vec_file.open(file_name, std::ios::out);
-        validate_is_file_created(write_vec_file, file_name);
+    /**
+     * @brief
+     * The function writes a .darc file holding the given series of data points in the given order.
+     * Each series is found by its name in O(1) time when the archive is read with DATA_ARCHIVE class, and
+     * reading every series in order reads the file sequentially. See ARCHIVE_HEADER for the layout of the file.
+     * The names must be unique; a series may be empty.
+     *
+     * @param[in] file_name file name to be written, it must contain file format .darc
+     * @param[in] series_names the name of each series
+     * @param[in] series_data the data points of each series
+     * @return true
+     * @return false
+     */
+    bool write_archive(const std::string file_name, std::span<const std::string> series_names, std::span<const DATA_SET> series_data)
+    {
+        validate_file_format(file_name, ".darc");
+        validate_archive_series(file_name, series_names, series_data);
 
-        std::string output_line;
-        output_line = std::to_string(vec_one.size());
-        write_vec_file << output_line << "\n";
+        ARCHIVE_HEADER archive_header;
+        archive_header.num_series = series_data.size();
+        archive_header.num_buckets = get_archive_num_buckets(series_data.size());
 
-        for (uint32_t iter = 0; iter < vec_one.size(); iter++)
+        std::vector<ARCHIVE_ENTRY> archive_entries(series_data.size());
+        std::vector<uint64_t> archive_buckets(static_cast<size_t>(archive_header.num_buckets), 0);
+        const uint64_t bucket_mask = archive_header.num_buckets - 1;
+        for (size_t iter = 0; iter < series_data.size(); iter++)
         {
-            write_vec_file << std::to_string(vec_one[iter]) << ", " << std::to_string(vec_two[iter]) << "\n";
+            ARCHIVE_ENTRY &archive_entry = archive_entries[iter];
+            archive_entry.name_offset = archive_header.names_bytes;
+            archive_entry.name_bytes = static_cast<uint32_t>(series_names[iter].size());
+            archive_entry.first_point = archive_header.num_data_points;
+            archive_entry.num_points = series_data[iter].size();
+            archive_header.names_bytes += archive_entry.name_bytes;
+            archive_header.num_data_points += archive_entry.num_points;
+
+            uint64_t bucket_index = get_archive_hash(series_names[iter]) & bucket_mask;
+            while (archive_buckets[bucket_index] != 0)
+            {
+                if (series_names[archive_buckets[bucket_index] - 1] == series_names[iter])
+                {
+                    throw_archive_error(file_name, "Series " + series_names[iter] + " appears more than once.");
+                }
+                bucket_index = (bucket_index + 1) & bucket_mask;
+            }
+            archive_buckets[bucket_index] = iter + 1;
         }
-        write_vec_file.close();
+
+        const uint64_t alignment = archive_header.column_alignment;
+        auto align_offset = [alignment](uint64_t byte_offset)
+        { return (byte_offset + alignment - 1) / alignment * alignment; };
+        archive_header.entries_offset = sizeof(ARCHIVE_HEADER);
+        archive_header.buckets_offset = archive_header.entries_offset + archive_entries.size() * sizeof(ARCHIVE_ENTRY);
+        archive_header.names_offset = archive_header.buckets_offset + archive_buckets.size() * sizeof(uint64_t);
+        archive_header.x_offset = align_offset(archive_header.names_offset + archive_header.names_bytes);
+        archive_header.y_offset = archive_header.x_offset + DBIN_HEADER::get_column_bytes(archive_header.num_data_points);
+
+        std::ofstream write_archive_file;
+        std::ostream &output_stream = open_output(write_archive_file, file_name);
+        const std::vector<char> column_padding(static_cast<size_t>(alignment), 0);
+        auto write_padding = [&](uint64_t written_bytes)
+        {
+            output_stream.write(column_padding.data(), static_cast<std::streamsize>(align_offset(written_bytes) - written_bytes));
+        };
+
+        output_stream.write(reinterpret_cast<const char *>(&archive_header), sizeof(ARCHIVE_HEADER));
+        output_stream.write(reinterpret_cast<const char *>(archive_entries.data()), archive_entries.size() * sizeof(ARCHIVE_ENTRY));
+        output_stream.write(reinterpret_cast<const char *>(archive_buckets.data()), archive_buckets.size() * sizeof(uint64_t));
+        for (const std::string &series_name : series_names)
+        {
+            output_stream.write(series_name.data(), static_cast<std::streamsize>(series_name.size()));
+        }
+        write_padding(archive_header.names_offset + archive_header.names_bytes);
+        for (const DATA_SET &data_set : series_data)
+        {
+            output_stream.write(reinterpret_cast<const char *>(data_set.get_x().data()), data_set.get_x().size_bytes());
+        }
+        write_padding(archive_header.num_data_points * sizeof(double));
+        for (const DATA_SET &data_set : series_data)
+        {
+            output_stream.write(reinterpret_cast<const char *>(data_set.get_y().data()), data_set.get_y().size_bytes());
+        }
+        write_padding(archive_header.num_data_points * sizeof(double));
+        close_output(output_stream, write_archive_file, file_name);
         return true;
     }
 
+    /**
+     * @brief
+     * The size of a buffer .dvec and .csv files are formatted into.
+     * It is large enough to make the cost of a write call negligible.
+     *
+     */
+    static constexpr size_t text_buffer_bytes = size_t(1) << 20;
+
 private:
+    std::vector<std::vector<char>> m_text_buffers;
+
+    /**
+     * @brief
+     * The function writes the count line and a line of "x<separator>y" for each data point.
+     * @details
+     * The data points are split into blocks that fit in a buffer of text_buffer_bytes bytes.
+     * Without a thread pool, a block is formatted and written at a time;
+     * with a thread pool, two blocks per thread are formatted concurrently and then written in order.
+     *
+     * @param[in] file_name file name to be written
+     * @param[in] vec_one collection of independent variables (X-Axis values) to be written
+     * @param[in] vec_two collection of dependent variables (Y-Axis values) to be written
+     * @param[in] separator text written between x and y
+     * @param[in] thread_pool threads formatting the lines concurrently, nullptr formats them on the calling thread
+     * @return true
+     */
+    bool write_text(const std::string &file_name, std::span<const double> vec_one, std::span<const double> vec_two,
+                    const std::string_view separator, THREAD_POOL *thread_pool)
+    {
+        // the longest line is two doubles of 24 characters, the separator and a line break
+        const size_t max_line_bytes = 2 * 24 + separator.size() + 1;
+        const size_t block_points = text_buffer_bytes / max_line_bytes;
+        const size_t num_blocks = (vec_one.size() + block_points - 1) / block_points;
+        const size_t num_threads = (thread_pool == nullptr) ? 1 : thread_pool->get_num_threads();
+        const size_t wave_blocks = std::min(num_blocks, (num_threads > 1) ? 2 * num_threads : size_t(1));
+
+        validate_compression_supported(file_name, "WRITE ERROR");
+        std::ofstream write_text_file;
+        std::ostream &output_stream = open_output(write_text_file, file_name);
+
+        std::unique_ptr<COMPRESS_STREAM> compress_stream;
+        if (get_compression(file_name) != COMPRESSION::NONE)
+        {
+            compress_stream = std::make_unique<COMPRESS_STREAM>(write_text_file, file_name);
+        }
+        auto write_bytes = [&](const char *text, size_t num_bytes)
+        {
+            if (compress_stream != nullptr)
+            {
+                compress_stream->write(text, num_bytes);
+            }
+            else
+            {
+                output_stream.write(text, static_cast<std::streamsize>(num_bytes));
+            }
+        };
+
+        char count_line[24];
+        char *count_end = std::to_chars(count_line, count_line + sizeof(count_line) - 1, vec_one.size()).ptr;
+        *count_end++ = '\n';
+        write_bytes(count_line, static_cast<size_t>(count_end - count_line));
+
+        this->m_text_buffers.resize(std::max(this->m_text_buffers.size(), wave_blocks));
+        std::vector<size_t> text_sizes(wave_blocks, 0);
+        auto format_block = [&](size_t wave_index, size_t block_index)
+        {
+            std::vector<char> &text_buffer = this->m_text_buffers[wave_index];
+            text_buffer.resize(text_buffer_bytes);
+            size_t first_point = block_index * block_points;
+            size_t last_point = std::min(first_point + block_points, vec_one.size());
+            text_sizes[wave_index] = static_cast<size_t>(
+                format_lines(text_buffer.data(), vec_one, vec_two, first_point, last_point, separator) - text_buffer.data());
+        };
+
+        for (size_t first_block = 0; first_block < num_blocks; first_block += wave_blocks)
+        {
+            size_t num_wave = std::min(wave_blocks, num_blocks - first_block);
+            if (num_wave > 1)
+            {
+                thread_pool->parallel_for(num_wave, [&](size_t wave_index, uint32_t)
+                                          { format_block(wave_index, first_block + wave_index); });
+            }
+            else
+            {
+                format_block(0, first_block);
+            }
+            for (size_t wave_index = 0; wave_index < num_wave; wave_index++)
+            {
+                write_bytes(this->m_text_buffers[wave_index].data(), text_sizes[wave_index]);
+            }
+        }
+        if (compress_stream != nullptr)
+        {
+            compress_stream->finish();
+        }
+        close_output(output_stream, write_text_file, file_name);
+        return true;
+    }
+
+    /**
+     * @brief
+     * The function opens the file to be written, or returns the standard output for standard_stream_name.
+     * It throws a runtime exception if the file cannot be created.
+     *
+     * @param[out] output_file The file object opened unless the standard output is used.
+     * @param[in] file_name name of file to be written
+     * @return std::ostream& The stream the data is written to.
+     */
+    std::ostream &open_output(std::ofstream &output_file, const std::string &file_name)
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            set_binary_mode(stdout);
+            return std::cout;
+        }
+        output_file.open(file_name, std::ios::out | std::ios::binary);
+        validate_is_file_created(output_file, file_name);
+        return output_file;
+    }
+
+    /**
+     * @brief
+     * The function closes the written file, or flushes the standard output, and
+     * throws a runtime exception if writing is failed.
+     *
+     * @param[in,out] output_stream The stream returned by open_output().
+     * @param[in,out] output_file The file object passed to open_output().
+     * @param[in] file_name name of the written file
+     */
+    void close_output(std::ostream &output_stream, std::ofstream &output_file, const std::string &file_name)
+    {
+        if (output_file.is_open() == true)
+        {
+            output_file.close();
+        }
+        else
+        {
+            output_stream.flush();
+        }
+        validate_is_file_written(output_stream, file_name);
+    }
+
+    /**
+     * @brief
+     * The function formats the lines of data points [first_point, last_point) with std::to_chars.
+     * The output must have room for the longest lines.
+     *
+     * @param[out] write_ptr The position the first line is written at.
+     * @param[in] vec_one collection of independent variables (X-Axis values) to be written
+     * @param[in] vec_two collection of dependent variables (Y-Axis values) to be written
+     * @param[in] first_point Index of the first data point.
+     * @param[in] last_point Index after the last data point.
+     * @param[in] separator text written between x and y
+     * @return char* The position after the last line.
+     */
+    static char *format_lines(char *write_ptr, std::span<const double> vec_one, std::span<const double> vec_two,
+                              const size_t first_point, const size_t last_point, const std::string_view separator)
+    {
+        for (size_t iter = first_point; iter < last_point; iter++)
+        {
+            write_ptr = std::to_chars(write_ptr, write_ptr + 24, vec_one[iter]).ptr;
+            write_ptr = std::copy(separator.begin(), separator.end(), write_ptr);
+            write_ptr = std::to_chars(write_ptr, write_ptr + 24, vec_two[iter]).ptr;
+            *write_ptr++ = '\n';
+        }
+        return write_ptr;
+    }
+
     /**
      * @brief
      * The function validates a passed vector is empty or not and
@@ -108,7 +402,7 @@ private:
      * @param[in] input_vec Collection of value
      * @param[in] vec_name Type of data collection, it is better to _x or _y to denote the vector contains dependent/independent variables.
      */
-    void validate_is_vector_empty(const std::vector<double> &input_vec, const std::string vec_name)
+    void validate_is_vector_empty(std::span<const double> input_vec, const std::string vec_name)
     {
         if (input_vec.empty() == true)
         {
@@ -128,7 +422,7 @@ private:
      * @param vec_one collection of independent variables (X-Axis values) to be written
      * @param vec_two collection of independent variables (Y-Axis values) to be written
      */
-    void validate_vector_length_match(const std::string file_name, const std::vector<double> &vec_one, const std::vector<double> &vec_two)
+    void validate_vector_length_match(const std::string file_name, std::span<const double> vec_one, std::span<const double> vec_two)
     {
         if (vec_one.size() != vec_two.size())
         {
@@ -152,6 +446,10 @@ private:
      */
     void validate_file_format(const std::string file_name, const std::string target_format)
     {
+        if (is_standard_stream(file_name) == true)
+        {
+            return; // the standard output is written in the format of the called method
+        }
         std::filesystem::path file_path(file_name);
         if (file_path.extension() != target_format)
         {
@@ -163,6 +461,54 @@ private:
         }
     }
 
+    /**
+     * @brief
+     * The function validates the series written into an archive and
+     * throws a runtime exception if there is no series, the numbers of names and series do not match,
+     * the length of a series does not match, or a name is empty or longer than 4 GiB.
+     *
+     * @param[in] file_name name of the archive to be written
+     * @param[in] series_names the name of each series
+     * @param[in] series_data the data points of each series
+     */
+    void validate_archive_series(const std::string &file_name, std::span<const std::string> series_names, std::span<const DATA_SET> series_data)
+    {
+        if (series_data.empty() == true)
+        {
+            std::string error_message =
+                "WRITE ERROR - NOTHING TO WRITE\n"
+                "There is no series to write into " + file_name + ".";
+            throw std::runtime_error(error_message);
+        }
+        if (series_names.size() != series_data.size())
+        {
+            throw_archive_error(file_name, "There are " + std::to_string(series_names.size()) + " names for " +
+                                               std::to_string(series_data.size()) + " series.");
+        }
+        for (size_t iter = 0; iter < series_data.size(); iter++)
+        {
+            validate_vector_length_match(file_name, series_data[iter].get_x(), series_data[iter].get_y());
+            if (series_names[iter].empty() == true || series_names[iter].size() > UINT32_MAX)
+            {
+                throw_archive_error(file_name, "The name of series " + std::to_string(iter + 1) + " is empty or too long.");
+            }
+        }
+    }
+
+    /**
+     * @brief The function throws a runtime exception for series that cannot be written into an archive.
+     *
+     * @param[in] file_name name of the archive to be written
+     * @param[in] reason The reason the series cannot be written.
+     */
+    [[noreturn]] static void throw_archive_error(const std::string &file_name, const std::string &reason)
+    {
+        std::string error_message =
+            "WRITE ERROR - INVALID ARCHIVE SERIES\n"
+            "Cannot write " + file_name + "\n" + reason + "\n";
+        throw std::runtime_error(error_message);
+    }
+
     /**
      * @brief
      * The function validates files to be written is generated or not and
@@ -181,4 +527,23 @@ private:
             throw std::runtime_error(error_message);
         }
     }
+
+    /**
+     * @brief
+     * The function validates the written file is closed without an error and
+     * throws a runtime exception if writing is failed, e.g. the disk is full.
+     *
+     * @param written_file object that points the written file
+     * @param file_name name of the written file
+     */
+    void validate_is_file_written(const std::ostream &written_file, const std::string &file_name)
+    {
+        if (written_file.fail() == true)
+        {
+            std::string error_message =
+                "WRITE ERROR - FAILED TO WRITE A FILE\n"
+                "Failed to write " + file_name + ".\n";
+            throw std::runtime_error(error_message);
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include "PCH.hpp"
+#include "data_stats.hpp"
+
+/**
+ * @brief
+ * ENUM CLASS that contains the types of values stored in .dbin file.
+ */
+enum class DBIN_DTYPE : uint32_t
+{
+    FLOAT64 = 1
+};
+
+/**
+ * @brief
+ * DBIN_HEADER structure is the header at the beginning of .dbin file, the binary data format of the project.
+ *
+ * @details
+ * .dbin file consists of
+ * - DBIN_HEADER (64 bytes)
+ * - the column of independent variables (X-Axis), starting at x_offset
+ * - the column of dependent variables (Y-Axis), starting at y_offset
+ * - the statistics footer (optional), starting at stats_offset: DATA_STATS of the whole data followed by
+ *   DATA_STATS of each block of stats_block_points data points, so the sums and the range are known without a scan
+ * Each column starts at a multiple of column_alignment (64 bytes) and is padded with zeros to the next multiple;
+ * therefore, when the file is mapped into memory, the columns are aligned to cache lines and
+ * can be used directly as arrays of double without parsing or copying.
+ * The values are written in the byte order of the machine that wrote the file, and
+ * endian_tag is read as 0x04030201 instead of 0x01020304 on a machine of the other byte order.
+ */
+struct DBIN_HEADER
+{
+    char magic[8] = {'P', 'R', 'O', 'J', 'D', 'B', 'I', 'N'};
+    uint32_t version = 1;
+    uint32_t endian_tag = 0x01020304;
+    uint64_t num_data_points = 0;
+    uint32_t dtype = static_cast<uint32_t>(DBIN_DTYPE::FLOAT64);
+    uint32_t column_alignment = 64;
+    uint64_t x_offset = 0;    // byte offset of the first independent variable from the beginning of the file
+    uint64_t y_offset = 0;    // byte offset of the first dependent variable from the beginning of the file
+    uint64_t stats_offset = 0;       // byte offset of the statistics footer, 0 if there is no footer
+    uint64_t stats_block_points = 0; // the number of data points of a block in the statistics footer
+
+    /**
+     * @brief The number of data points of a block in the statistics footer written by the program.
+     *
+     */
+    static constexpr uint64_t default_stats_block_points = 65536;
+
+    /**
+     * @brief Gets the size of a column including its padding.
+     *
+     * @param[in] num_data_points The number of data points.
+     * @return uint64_t
+     */
+    static uint64_t get_column_bytes(const uint64_t num_data_points)
+    {
+        const uint64_t alignment = 64;
+        return (num_data_points * sizeof(double) + alignment - 1) / alignment * alignment;
+    }
+};
+static_assert(sizeof(DBIN_HEADER) == 64, "DBIN_HEADER must be 64 bytes");
@@ -0,0 +1,310 @@
+/**
+ * The file contains facade version of robust regression and outlier detection over many independent data sets.
+ *
+ */
+#pragma once
+#include "facade_regression.hpp"
+#include "facade_detection.hpp"
+#include "data_set.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @brief Result of robust regression and outlier detection of a data set in a batch.
+ *
+ */
+struct BATCH_RESULT
+{
+    double m_slope = 0.0;
+    double b_intercept = 0.0;
+    uint32_t num_iteration = 0;
+    uint32_t num_outlier = 0;
+    DATA_SET outliers;
+    DATA_SET inliers;
+};
+
+/**
+ * @brief
+ *  FACADE_BATCH class performs robust regression and outlier detection on many independent data sets.
+ *
+ * @details
+ *  FACADE_BATCH class applies the same weight function and detection method to every data set and
+ *  returns the results in the order of the given data sets.
+ *  The data sets run concurrently on a thread pool:
+ *  - threads claim the data sets one by one from a shared counter instead of receiving a fixed share,
+ *    so a thread that finished small data sets keeps taking new ones while another works on a large one.
+ *  - the data sets are started from the largest one, so a large data set is not left to run alone at the end.
+ *  - a data set larger than a chunk runs its passes over the data chunk by chunk on the same thread pool,
+ *    so threads that ran out of data sets help the remaining large ones.
+ *  Each thread keeps a ROBUST_FIT object as its workspace and reuses its buffers for every data set it takes.
+ *  FACADE_BATCH class uses ROBUST_FIT and OUTLIER_DETECTION with has-a relation.
+ */
+class FACADE_BATCH
+{
+public:
+    /**
+     * @brief Construct a new FACADE_BATCH object with the methods applied to every data set.
+     *
+     * @param[in] reg_method Weight function that will be used for robust regression computation.
+     * @param[in] det_method Outlier detection method applied to the result of robust regression.
+     */
+    FACADE_BATCH(const REGRESSION_METHOD reg_method, const DETECTION_METHOD det_method)
+        : m_reg_method(reg_method), m_det_method(det_method)
+    {
+    }
+
+    /**
+     * @brief The default destructor, no special action required.
+     *
+     */
+    ~FACADE_BATCH() {}
+
+    /**
+     * @brief Sets the other methods applied to every data set.
+     *
+     * @param[in] reg_method Weight function that will be used for robust regression computation.
+     * @param[in] det_method Outlier detection method applied to the result of robust regression.
+     */
+    void set_method(const REGRESSION_METHOD reg_method, const DETECTION_METHOD det_method)
+    {
+        this->m_reg_method = reg_method;
+        this->m_det_method = det_method;
+    }
+
+    /**
+     * @brief
+     * Runs the batch on a new thread pool of num_threads threads.
+     * If it is not used, a thread pool of the number of hardware threads is created by proceed_batch().
+     *
+     * @param[in] num_threads The number of threads, zero means the number of hardware threads.
+     * @param[in] chunk_size The number of data points processed by a task, zero means the default size.
+     */
+    void set_parallel(const uint32_t num_threads, const uint32_t chunk_size = 0)
+    {
+        this->set_parallel(std::make_shared<THREAD_POOL>(num_threads), chunk_size);
+    }
+
+    /**
+     * @brief Runs the batch on the given thread pool, which can be shared with other objects.
+     *
+     * @param[in] thread_pool Threads used for the computation.
+     * @param[in] chunk_size The number of data points processed by a task, zero means the default size.
+     */
+    void set_parallel(std::shared_ptr<THREAD_POOL> thread_pool, const uint32_t chunk_size = 0)
+    {
+        this->m_thread_pool = std::move(thread_pool);
+        this->m_chunk_size = chunk_size;
+        this->m_workspaces = nullptr;
+    }
+
+    /**
+     * @brief
+     * Performs robust regression and outlier detection on every given data set.
+     * @details
+     * The result of a data set is the same as FACADE_REGRESSION and FACADE_DETECTION
+     * running on the same thread pool and chunk size.
+     * If a data set throws an exception, the remaining data sets still run and the first exception is rethrown.
+     * The workspaces are kept after the call and reused by the next call with the same weight function;
+     * therefore, repeated calls on data sets of similar sizes do not allocate them again.
+     *
+     * @param[in] observed_sets A collection of independent data sets.
+     * @return std::vector<BATCH_RESULT> The results in the order of observed_sets.
+     */
+    std::vector<BATCH_RESULT> proceed_batch(const std::vector<DATA_SET> &observed_sets)
+    {
+        std::vector<size_t> set_order(observed_sets.size());
+        std::iota(set_order.begin(), set_order.end(), size_t(0));
+        std::stable_sort(set_order.begin(), set_order.end(), [&observed_sets](size_t lhs, size_t rhs)
+                         { return observed_sets[lhs].size() > observed_sets[rhs].size(); });
+
+        std::vector<BATCH_RESULT> results(observed_sets.size());
+        this->proceed_batch(
+            observed_sets.size(),
+            [&](size_t task_index)
+            { return observed_sets[set_order[task_index]]; },
+            [&](size_t task_index, const DATA_SET &, BATCH_RESULT &&result)
+            { results[set_order[task_index]] = std::move(result); });
+        return results;
+    }
+
+    /**
+     * @brief
+     * Performs robust regression and outlier detection on data sets that are loaded and stored by the caller.
+     * @details
+     * For every set_index in [0, num_sets), a thread calls load_set(set_index), performs the computation and
+     * calls store_result(set_index, observed_data, result) right after it.
+     * The data sets are started in the order of set_index, and none of them is kept after store_result() returns;
+     * therefore, loading, computation and storing of different data sets overlap, and
+     * the memory in use depends on the number of threads instead of the number of data sets.
+     * Start the large data sets first for the best balance.
+     * An empty data set is not computed, and the default BATCH_RESULT is given to store_result().
+     * If a function throws an exception, the remaining data sets still run and the first exception is rethrown.
+     *
+     * @tparam LOAD_FUNCTION A callable object with signature DATA_SET(size_t).
+     * @tparam STORE_FUNCTION A callable object with signature void(size_t, const DATA_SET &, BATCH_RESULT &&).
+     * @param[in] num_sets The number of data sets.
+     * @param[in] load_set The function that gives the data set of an index, called concurrently.
+     * @param[in] store_result The function that takes the result of an index, called concurrently.
+     */
+    template <typename LOAD_FUNCTION, typename STORE_FUNCTION>
+    void proceed_batch(const size_t num_sets, LOAD_FUNCTION &&load_set, STORE_FUNCTION &&store_result)
+    {
+        if (this->m_thread_pool == nullptr)
+        {
+            this->m_thread_pool = std::make_shared<THREAD_POOL>();
+        }
+
+        switch (this->m_reg_method)
+        {
+        case REGRESSION_METHOD::ANDREWS:
+            this->proceed_estimator<M_ESTIMATOR_ANDREWS>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::BISQUARE:
+            this->proceed_estimator<M_ESTIMATOR_BISQUARE>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::CAUCHY:
+            this->proceed_estimator<M_ESTIMATOR_CAUCHY>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::FAIR:
+            this->proceed_estimator<M_ESTIMATOR_FAIR>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::HUBER:
+            this->proceed_estimator<M_ESTIMATOR_HUBER>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::LOGISTIC:
+            this->proceed_estimator<M_ESTIMATOR_LOGISTIC>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::TALWAR:
+            this->proceed_estimator<M_ESTIMATOR_TALWAR>(num_sets, load_set, store_result);
+            break;
+
+        case REGRESSION_METHOD::WELSCH:
+            this->proceed_estimator<M_ESTIMATOR_WELSCH>(num_sets, load_set, store_result);
+            break;
+        }
+    }
+
+private:
+    REGRESSION_METHOD m_reg_method;
+    DETECTION_METHOD m_det_method;
+    std::shared_ptr<THREAD_POOL> m_thread_pool;
+    uint32_t m_chunk_size = 0;
+    std::shared_ptr<void> m_workspaces; // std::vector<ROBUST_FIT<ESTIMATOR>> of m_workspace_method
+    REGRESSION_METHOD m_workspace_method;
+
+    /**
+     * @brief Gets the workspaces of the current weight function, one per thread, creating them if needed.
+     *
+     * @tparam ESTIMATOR One of M_ESTIMATOR_* classes.
+     * @return std::vector<ROBUST_FIT<ESTIMATOR>>&
+     */
+    template <typename ESTIMATOR>
+    std::vector<ROBUST_FIT<ESTIMATOR>> &get_workspaces()
+    {
+        if (this->m_workspaces == nullptr || this->m_workspace_method != this->m_reg_method)
+        {
+            THREAD_POOL &thread_pool = *this->m_thread_pool;
+            auto workspaces = std::make_shared<std::vector<ROBUST_FIT<ESTIMATOR>>>();
+            workspaces->reserve(thread_pool.get_num_threads());
+            for (uint32_t iter = 0; iter < thread_pool.get_num_threads(); iter++)
+            {
+                workspaces->emplace_back(DATA_SET());
+                workspaces->back().set_parallel(thread_pool, this->m_chunk_size);
+            }
+            this->m_workspaces = workspaces;
+            this->m_workspace_method = this->m_reg_method;
+        }
+        return *std::static_pointer_cast<std::vector<ROBUST_FIT<ESTIMATOR>>>(this->m_workspaces);
+    }
+
+    /**
+     * @brief Performs the batch with ROBUST_FIT<ESTIMATOR> workspaces, one per thread.
+     *
+     * @tparam ESTIMATOR One of M_ESTIMATOR_* classes.
+     * @param[in] num_sets The number of data sets.
+     * @param[in] load_set The function that gives the data set of an index.
+     * @param[in] store_result The function that takes the result of an index.
+     */
+    template <typename ESTIMATOR, typename LOAD_FUNCTION, typename STORE_FUNCTION>
+    void proceed_estimator(const size_t num_sets, LOAD_FUNCTION &load_set, STORE_FUNCTION &store_result)
+    {
+        THREAD_POOL &thread_pool = *this->m_thread_pool;
+        std::vector<ROBUST_FIT<ESTIMATOR>> &workspaces = this->get_workspaces<ESTIMATOR>();
+
+        thread_pool.parallel_for(num_sets, [&](size_t set_index, uint32_t thread_index)
+                                 {
+                                     DATA_SET observed_data = load_set(set_index);
+                                     BATCH_RESULT result;
+                                     if (observed_data.empty() == false)
+                                     {
+                                         result = this->proceed_set(observed_data, workspaces[thread_index]);
+                                     }
+                                     store_result(set_index, observed_data, std::move(result)); });
+
+        for (auto &workspace : workspaces)
+        {
+            workspace.set_observed(DATA_SET()); // releases the data sets, the buffers keep their capacity
+        }
+    }
+
+    /**
+     * @brief Performs robust regression and outlier detection on a data set with the given workspace.
+     *
+     * @tparam ESTIMATOR One of M_ESTIMATOR_* classes.
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in,out] workspace ROBUST_FIT object reused by the calling thread.
+     * @return BATCH_RESULT
+     */
+    template <typename ESTIMATOR>
+    BATCH_RESULT proceed_set(const DATA_SET &observed_data, ROBUST_FIT<ESTIMATOR> &workspace)
+    {
+        workspace.set_observed(observed_data);
+        workspace.perform_regression();
+
+        BATCH_RESULT result;
+        result.m_slope = workspace.get_slope();
+        result.b_intercept = workspace.get_intercept();
+        result.num_iteration = workspace.get_num_iteration();
+
+        std::vector<double> x_outliers;
+        std::vector<double> y_outliers;
+        std::vector<double> x_inliers;
+        std::vector<double> y_inliers;
+        OUTLIER_DETECTION outlier_detect;
+        switch (this->m_det_method)
+        {
+        case DETECTION_METHOD::STANDARDIZED_RESIDUAL:
+            outlier_detect.detection_by_standardized_residual(
+                observed_data.get_x(),
+                observed_data.get_y(),
+                result.m_slope,
+                result.b_intercept,
+                result.num_outlier,
+                x_outliers,
+                y_outliers,
+                x_inliers,
+                y_inliers);
+            break;
+
+        case DETECTION_METHOD::WEIGHT:
+            outlier_detect.detection_by_weight(
+                observed_data.get_x(),
+                observed_data.get_y(),
+                workspace.get_weight(),
+                result.num_outlier,
+                x_outliers,
+                y_outliers,
+                x_inliers,
+                y_inliers);
+            break;
+        }
+        result.outliers = DATA_SET(std::move(x_outliers), std::move(y_outliers));
+        result.inliers = DATA_SET(std::move(x_inliers), std::move(y_inliers));
+        return result;
+    }
+};
@@ -4,6 +4,7 @@
  */
 #pragma once
 #include "outlier_detection.hpp"
+#include "data_set.hpp"
 
 /**
  * @brief
@@ -86,21 +87,30 @@ public:
         const std::vector<double> &y_observed,
         const double m_slope,
         const double b_intercept)
+        : FACADE_DETECTION(DATA_SET(x_observed, y_observed), m_slope, b_intercept)
     {
-        this->m_x_observed = x_observed;
-        this->m_y_observed = y_observed;
+    }
+
+    /**
+     * @brief
+     * Constructs a new FACADE_DETECTION object and initializes the object is ready for
+     * outlier detection by standardized residual.
+     * The observed data is shared with the given DATA_SET object without copying it.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] m_slope A slope of line of best fit computed from linear regression method.
+     * @param[in] b_intercept A intercept of line of best fit computed from linear regression method.
+     */
+    FACADE_DETECTION(
+        const DATA_SET &observed_data,
+        const double m_slope,
+        const double b_intercept)
+    {
+        this->m_observed_data = observed_data;
         this->m_m_slope = m_slope;
         this->m_b_intercept = b_intercept;
         this->ready_standardized_detection = true;
         this->ready_weight_detection = false;
-
-        uint32_t num_data = static_cast<uint32_t>(x_observed.size());
-        uint32_t num_expected_outlier = static_cast<uint32_t>(num_data * 0.25);
-        uint32_t num_expected_inlier = static_cast<uint32_t>(num_data * 0.75);
-        m_x_outliers.reserve(num_expected_outlier);
-        m_y_outliers.reserve(num_expected_outlier);
-        m_x_inliers.reserve(num_expected_inlier);
-        m_y_inliers.reserve(num_expected_inlier);
     }
 
     /**
@@ -118,20 +128,28 @@ public:
         const std::vector<double> &x_observed,
         const std::vector<double> &y_observed,
         const std::vector<double> &w_weight)
+        : FACADE_DETECTION(DATA_SET(x_observed, y_observed), std::vector<double>(w_weight))
     {
-        this->m_x_observed = x_observed;
-        this->m_y_observed = y_observed;
-        this->m_w_weight = w_weight;
+    }
+
+    /**
+     * @brief
+     * Constructs a new FACADE_DETECTION object and initializes the object is ready for
+     * outlier detection by weight.
+     * The observed data is shared with the given DATA_SET object, and
+     * the weight is moved into the object if an rvalue is given.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] w_weight A collection of weight of each variables in observed data.
+     */
+    FACADE_DETECTION(
+        const DATA_SET &observed_data,
+        std::vector<double> w_weight)
+    {
+        this->m_observed_data = observed_data;
+        this->m_w_weight = std::move(w_weight);
         this->ready_standardized_detection = false;
         this->ready_weight_detection = true;
-
-        uint32_t num_data = static_cast<uint32_t>(x_observed.size());
-        uint32_t num_expected_outlier = static_cast<uint32_t>(num_data * 0.25);
-        uint32_t num_expected_inlier = static_cast<uint32_t>(num_data * 0.75);
-        m_x_outliers.reserve(num_expected_outlier);
-        m_y_outliers.reserve(num_expected_outlier);
-        m_x_inliers.reserve(num_expected_inlier);
-        m_y_inliers.reserve(num_expected_inlier);
     }
 
     /**
@@ -151,22 +169,34 @@ public:
         const std::vector<double> &w_weight,
         const double m_slope,
         const double b_intercept)
+        : FACADE_DETECTION(DATA_SET(x_observed, y_observed), std::vector<double>(w_weight), m_slope, b_intercept)
     {
-        this->m_x_observed = x_observed;
-        this->m_y_observed = y_observed;
-        this->m_w_weight = w_weight;
+    }
+
+    /**
+     * @brief
+     * Constructs a new FACADE_DETECTION object and initializes the object is ready for
+     * outlier detection by both standardized residual and weight.
+     * The observed data is shared with the given DATA_SET object, and
+     * the weight is moved into the object if an rvalue is given.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] w_weight A collection of weight of each variables in observed data.
+     * @param[in] m_slope A slope of line of best fit computed from linear regression method.
+     * @param[in] b_intercept A intercept of line of best fit computed from linear regression method.
+     */
+    FACADE_DETECTION(
+        const DATA_SET &observed_data,
+        std::vector<double> w_weight,
+        const double m_slope,
+        const double b_intercept)
+    {
+        this->m_observed_data = observed_data;
+        this->m_w_weight = std::move(w_weight);
         this->m_m_slope = m_slope;
         this->m_b_intercept = b_intercept;
         this->ready_standardized_detection = true;
         this->ready_weight_detection = true;
-
-        uint32_t num_data = static_cast<uint32_t>(x_observed.size());
-        uint32_t num_expected_outlier = static_cast<uint32_t>(num_data * 0.25);
-        uint32_t num_expected_inlier = static_cast<uint32_t>(num_data * 0.75);
-        m_x_outliers.reserve(num_expected_outlier);
-        m_y_outliers.reserve(num_expected_outlier);
-        m_x_inliers.reserve(num_expected_inlier);
-        m_y_inliers.reserve(num_expected_inlier);
     }
 
     /**
@@ -219,8 +249,18 @@ public:
      */
     void get_outliers(std::vector<double> &x_outliers, std::vector<double> &y_outliers)
     {
-        x_outliers = this->m_x_outliers;
-        y_outliers = this->m_y_outliers;
+        x_outliers.assign(this->m_outliers.get_x().begin(), this->m_outliers.get_x().end());
+        y_outliers.assign(this->m_outliers.get_y().begin(), this->m_outliers.get_y().end());
+    }
+
+    /**
+     * @brief Get the collection of detected outliers, the data is shared not copied.
+     *
+     * @return const DATA_SET&
+     */
+    const DATA_SET &get_outliers() const
+    {
+        return this->m_outliers;
     }
 
     /**
@@ -231,21 +271,28 @@ public:
      */
     void get_inliers(std::vector<double> &x_inliers, std::vector<double> &y_inliers)
     {
-        x_inliers = this->m_x_inliers;
-        y_inliers = this->m_y_inliers;
+        x_inliers.assign(this->m_inliers.get_x().begin(), this->m_inliers.get_x().end());
+        y_inliers.assign(this->m_inliers.get_y().begin(), this->m_inliers.get_y().end());
+    }
+
+    /**
+     * @brief Get the collection of detected inliers, the data is shared not copied.
+     *
+     * @return const DATA_SET&
+     */
+    const DATA_SET &get_inliers() const
+    {
+        return this->m_inliers;
     }
 
 private:
     uint32_t m_num_outliers = 0;
     double m_m_slope;
     double m_b_intercept;
-    std::vector<double> m_x_observed;
-    std::vector<double> m_y_observed;
+    DATA_SET m_observed_data;
+    DATA_SET m_outliers;
+    DATA_SET m_inliers;
     std::vector<double> m_w_weight;
-    std::vector<double> m_x_outliers;
-    std::vector<double> m_y_outliers;
-    std::vector<double> m_x_inliers;
-    std::vector<double> m_y_inliers;
     bool ready_weight_detection = false;
     bool ready_standardized_detection = false;
 
@@ -266,16 +313,23 @@ private:
                 "Use of standardized detection is chosen, but the object is not initialized for it.\n";
             throw std::runtime_error(error_message);
         }
+        std::vector<double> x_outliers;
+        std::vector<double> y_outliers;
+        std::vector<double> x_inliers;
+        std::vector<double> y_inliers;
+        this->reserve_partition(x_outliers, y_outliers, x_inliers, y_inliers);
         OUTLIER_DETECTION::detection_by_standardized_residual(
-            m_x_observed,
-            m_y_observed,
+            m_observed_data.get_x(),
+            m_observed_data.get_y(),
             m_m_slope,
             m_b_intercept,
             m_num_outliers,
-            m_x_outliers,
-            m_y_outliers,
-            m_x_inliers,
-            m_y_inliers);
+            x_outliers,
+            y_outliers,
+            x_inliers,
+            y_inliers);
+        this->m_outliers = DATA_SET(std::move(x_outliers), std::move(y_outliers));
+        this->m_inliers = DATA_SET(std::move(x_inliers), std::move(y_inliers));
     }
 
     /**
@@ -295,14 +349,44 @@ private:
                 "Use of weight detection is chosen, but the object is not initialized for it.\n";
             throw std::runtime_error(error_message);
         }
+        std::vector<double> x_outliers;
+        std::vector<double> y_outliers;
+        std::vector<double> x_inliers;
+        std::vector<double> y_inliers;
+        this->reserve_partition(x_outliers, y_outliers, x_inliers, y_inliers);
         OUTLIER_DETECTION::detection_by_weight(
-            m_x_observed,
-            m_y_observed,
+            m_observed_data.get_x(),
+            m_observed_data.get_y(),
             m_w_weight,
             m_num_outliers,
-            m_x_outliers,
-            m_y_outliers,
-            m_x_inliers,
-            m_y_inliers);
+            x_outliers,
+            y_outliers,
+            x_inliers,
+            y_inliers);
+        this->m_outliers = DATA_SET(std::move(x_outliers), std::move(y_outliers));
+        this->m_inliers = DATA_SET(std::move(x_inliers), std::move(y_inliers));
+    }
+
+    /**
+     * @brief Reserves the expected size of outlier and inlier collections.
+     *
+     * @param[out] x_outliers A collection of outliers in observed data's independent variables (X-Axis).
+     * @param[out] y_outliers A collection of outliers in observed data's dependent variables (Y-Axis).
+     * @param[out] x_inliers A collection of inliers in observed data's independent variables (X-Axis).
+     * @param[out] y_inliers A collection of inliers in observed data's dependent variables (Y-Axis).
+     */
+    void reserve_partition(
+        std::vector<double> &x_outliers,
+        std::vector<double> &y_outliers,
+        std::vector<double> &x_inliers,
+        std::vector<double> &y_inliers)
+    {
+        uint32_t num_data = static_cast<uint32_t>(m_observed_data.size());
+        uint32_t num_expected_outlier = static_cast<uint32_t>(num_data * 0.25);
+        uint32_t num_expected_inlier = static_cast<uint32_t>(num_data * 0.75);
+        x_outliers.reserve(num_expected_outlier);
+        y_outliers.reserve(num_expected_outlier);
+        x_inliers.reserve(num_expected_inlier);
+        y_inliers.reserve(num_expected_inlier);
     }
 };
\ No newline at end of file
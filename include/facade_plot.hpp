@@ -38,13 +38,36 @@ public:
         const std::vector<double> &x_inlier,
         const std::vector<double> &y_inlier,
         const double slope,
-        const double intercept) : OUTLIER_PLOT(x_observed, y_observed),
-                                  m_x_observed(x_observed),
-                                  m_y_observed(y_observed),
-                                  m_x_outlier(x_outlier),
-                                  m_y_outlier(y_outlier),
-                                  m_x_inlier(x_inlier),
-                                  m_y_inlier(y_inlier),
+        const double intercept)
+        : FACADE_PLOT(
+              DATA_SET(x_observed, y_observed),
+              DATA_SET(x_outlier, y_outlier),
+              DATA_SET(x_inlier, y_inlier),
+              slope,
+              intercept)
+    {
+    }
+
+    /**
+     * @brief
+     * Construct a new FACADE_PLOT object and initializes entire data to generate output.
+     * The data points are shared with the given DATA_SET objects without copying them.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] outliers A collection of outliers in observed data.
+     * @param[in] inliers A collection of inliers in observed data.
+     * @param[in] slope A slope of line of best fit computed from linear regression method.
+     * @param[in] intercept A intercept of line of best fit computed from linear regression method.
+     */
+    FACADE_PLOT(
+        const DATA_SET &observed_data,
+        const DATA_SET &outliers,
+        const DATA_SET &inliers,
+        const double slope,
+        const double intercept) : OUTLIER_PLOT(observed_data),
+                                  m_observed_data(observed_data),
+                                  m_outliers(outliers),
+                                  m_inliers(inliers),
                                   m_slope(slope),
                                   m_intercept(intercept)
     {
@@ -75,7 +98,7 @@ public:
      */
     void draw_observed_point(RGB_COLOUR marker_colour, uint32_t marker_size)
     {
-        draw_data_points(m_x_observed, m_y_observed, marker_colour, marker_size);
+        draw_data_points(m_observed_data.get_x(), m_observed_data.get_y(), marker_colour, marker_size);
     }
 
     /**
@@ -86,7 +109,7 @@ public:
      */
     void draw_outlier_point(RGB_COLOUR marker_colour, uint32_t marker_size)
     {
-        draw_data_points(m_x_outlier, m_y_outlier, marker_colour, marker_size);
+        draw_data_points(m_outliers.get_x(), m_outliers.get_y(), marker_colour, marker_size);
     }
 
     /**
@@ -97,7 +120,7 @@ public:
      */
     void draw_inlier_point(RGB_COLOUR marker_colour, uint32_t marker_size)
     {
-        draw_data_points(m_x_inlier, m_y_inlier, marker_colour, marker_size);
+        draw_data_points(m_inliers.get_x(), m_inliers.get_y(), marker_colour, marker_size);
     }
 
     /**
@@ -137,12 +160,9 @@ public:
     }
 
 private:
-    std::vector<double> m_x_observed;
-    std::vector<double> m_y_observed;
-    std::vector<double> m_x_outlier;
-    std::vector<double> m_y_outlier;
-    std::vector<double> m_x_inlier;
-    std::vector<double> m_y_inlier;
+    DATA_SET m_observed_data;
+    DATA_SET m_outliers;
+    DATA_SET m_inliers;
 
     double m_slope;
     double m_intercept;
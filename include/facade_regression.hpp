@@ -4,7 +4,11 @@
  */
 #pragma once
 #include "PCH.hpp"
+#include "data_set.hpp"
+#include "thread_pool.hpp"
 #include "regression_robust.hpp"
+#include "robust_fit.hpp"
+#include <chrono>
 #include "m_estimator_andrews.hpp"
 #include "m_estimator_bisquare.hpp"
 #include "m_estimator_cauchy.hpp"
@@ -66,6 +70,85 @@ REGRESSION_METHOD validate_reg_method(const std::string &target_method)
     return iter_method_list->second;
 }
 
+/**
+ * @brief
+ * Validates a comma-separated list of methods given through command-line argument, e.g. "bisquare,huber".
+ * "all" selects every method in the order of REGRESSION_METHOD.
+ * It throws a runtime exception if one of the methods does not exist in the predefined list.
+ *
+ * @param[in] target_methods comma-separated list of targeted methods
+ * @return std::vector<REGRESSION_METHOD>
+ */
+std::vector<REGRESSION_METHOD> validate_reg_method_list(const std::string &target_methods)
+{
+    if (target_methods == "all")
+    {
+        return {REGRESSION_METHOD::ANDREWS,
+                REGRESSION_METHOD::BISQUARE,
+                REGRESSION_METHOD::CAUCHY,
+                REGRESSION_METHOD::FAIR,
+                REGRESSION_METHOD::HUBER,
+                REGRESSION_METHOD::LOGISTIC,
+                REGRESSION_METHOD::TALWAR,
+                REGRESSION_METHOD::WELSCH};
+    }
+
+    std::vector<REGRESSION_METHOD> method_list;
+    size_t name_begin = 0;
+    while (name_begin <= target_methods.size())
+    {
+        size_t name_end = target_methods.find(',', name_begin);
+        name_end = (name_end == std::string::npos) ? target_methods.size() : name_end;
+        method_list.push_back(validate_reg_method(target_methods.substr(name_begin, name_end - name_begin)));
+        name_begin = name_end + 1;
+    }
+    return method_list;
+}
+
+/**
+ * @brief Gets the name of the method used in command-line argument.
+ *
+ * @param[in] target_method targeted method
+ * @return std::string
+ */
+std::string get_reg_method_name(const REGRESSION_METHOD target_method)
+{
+    switch (target_method)
+    {
+    case REGRESSION_METHOD::ANDREWS:
+        return "andrews";
+    case REGRESSION_METHOD::BISQUARE:
+        return "bisquare";
+    case REGRESSION_METHOD::CAUCHY:
+        return "cauchy";
+    case REGRESSION_METHOD::FAIR:
+        return "fair";
+    case REGRESSION_METHOD::HUBER:
+        return "huber";
+    case REGRESSION_METHOD::LOGISTIC:
+        return "logistic";
+    case REGRESSION_METHOD::TALWAR:
+        return "talwar";
+    case REGRESSION_METHOD::WELSCH:
+        return "welsch";
+    }
+    return "";
+}
+
+/**
+ * @brief Result of robust regression with a weight function.
+ *
+ */
+struct REGRESSION_RESULT
+{
+    REGRESSION_METHOD method = REGRESSION_METHOD::BISQUARE;
+    double m_slope = 0.0;
+    double b_intercept = 0.0;
+    uint32_t num_iteration = 0;
+    double wall_time = 0.0;          // seconds spent by the regression
+    std::vector<double> w_weight; // empty if the weight is not requested
+};
+
 /**
  * @brief
  *  FACADE_REGRESSION class is a simplified version of REGRESSION_ROBUST class.
@@ -109,11 +192,29 @@ public:
         m_is_data_initialized = true;
         m_is_method_initialized = true;
 
-        this->m_x_observed = x_observed;
-        this->m_y_observed = y_observed;
+        this->m_observed_data = DATA_SET(x_observed, y_observed);
+        this->m_target_method = target_method;
+
+        this->m_m_slope = 0.0;
+        this->m_b_intercept = 0.0;
+    }
+
+    /**
+     * @brief
+     * Construct a new FACADE_REGRESSION object that is fully initialized member variables.
+     * The observed data is shared with the given DATA_SET object without copying it.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] target_method Weight function that will be used for robust regression computation.
+     */
+    FACADE_REGRESSION(const DATA_SET &observed_data, const REGRESSION_METHOD target_method)
+    {
+        m_is_data_initialized = true;
+        m_is_method_initialized = true;
+
+        this->m_observed_data = observed_data;
         this->m_target_method = target_method;
 
-        this->m_w_weight = std::vector<double>(x_observed.size(), 0);
         this->m_m_slope = 0.0;
         this->m_b_intercept = 0.0;
     }
@@ -128,6 +229,10 @@ public:
      * @brief
      * Perfroms robust regression with the initialized member variables.
      * Must be used after initialization; otherwise, it would throw a runtime error.
+     * @details
+     * With IRLS_ENGINE::FUSED (default), the chosen weight function is mapped onto
+     * a ROBUST_FIT specialization constructed on the stack.
+     * With IRLS_ENGINE::STANDARD, REGRESSION_ROBUST derived class is allocated and used through virtual functions.
      *
      */
     void proceed_regression()
@@ -135,53 +240,54 @@ public:
         validate_data_initialization();
         validate_method_initialization();
 
-        REGRESSION_ROBUST *regression = nullptr;
-        switch (this->m_target_method)
+        switch (this->m_engine)
         {
-        case REGRESSION_METHOD::ANDREWS:
-            regression = new M_ESTIMATOR_ANDREWS(m_x_observed, m_y_observed);
-            break;
-
-        case REGRESSION_METHOD::BISQUARE:
-            regression = new M_ESTIMATOR_BISQUARE(m_x_observed, m_y_observed);
-            break;
-
-        case REGRESSION_METHOD::CAUCHY:
-            regression = new M_ESTIMATOR_CAUCHY(m_x_observed, m_y_observed);
-            break;
-
-        case REGRESSION_METHOD::FAIR:
-            regression = new M_ESTIMATOR_FAIR(m_x_observed, m_y_observed);
-            break;
-
-        case REGRESSION_METHOD::HUBER:
-            regression = new M_ESTIMATOR_HUBER(m_x_observed, m_y_observed);
+        case IRLS_ENGINE::STANDARD:
+            this->proceed_regression_dynamic();
             break;
 
-        case REGRESSION_METHOD::LOGISTIC:
-            regression = new M_ESTIMATOR_LOGISTIC(m_x_observed, m_y_observed);
-            break;
-
-        case REGRESSION_METHOD::TALWAR:
-            regression = new M_ESTIMATOR_TALWAR(m_x_observed, m_y_observed);
+        case IRLS_ENGINE::FUSED:
+            this->proceed_regression_static();
             break;
+        }
+    }
 
-        case REGRESSION_METHOD::WELSCH:
-            regression = new M_ESTIMATOR_WELSCH(m_x_observed, m_y_observed);
-            break;
+    /**
+     * @brief
+     * Performs robust regression with every given weight function on the same data and
+     * returns the results in the given order.
+     * @details
+     * The part of computation that does not depend on the weight function (IRLS_SETUP) is computed once,
+     * and the weight functions run concurrently on the thread pool set by set_parallel().
+     * If the thread pool is not set, a thread pool with a thread per weight function is used
+     * (up to the number of hardware threads), and each regression runs on a single thread.
+     * It uses IRLS_ENGINE::FUSED regardless of set_engine(); the weights are not kept.
+     *
+     * @param[in] target_methods Weight functions to be compared.
+     * @return std::vector<REGRESSION_RESULT>
+     */
+    std::vector<REGRESSION_RESULT> proceed_comparison(const std::vector<REGRESSION_METHOD> &target_methods)
+    {
+        validate_data_initialization();
 
-        default:
-            break;
+        THREAD_POOL *inner_pool = m_thread_pool.get();
+        std::shared_ptr<THREAD_POOL> outer_pool = m_thread_pool;
+        if (outer_pool == nullptr)
+        {
+            uint32_t num_threads = std::min<uint32_t>(static_cast<uint32_t>(target_methods.size()),
+                                                      std::max(std::thread::hardware_concurrency(), 1u));
+            outer_pool = std::make_shared<THREAD_POOL>(std::max(num_threads, 1u));
         }
 
-        regression->perform_regression();
+        uint32_t chunk_size = (m_chunk_size == 0) ? ROBUST_FIT<M_ESTIMATOR_BISQUARE>::default_chunk_size : m_chunk_size;
+        auto irls_setup = std::make_shared<const IRLS_SETUP>(m_observed_data, inner_pool, chunk_size);
 
-        m_m_slope = regression->get_slope();
-        m_b_intercept = regression->get_intercept();
-        regression->get_weight(m_w_weight);
-
-        delete regression;
-        regression = nullptr;
+        std::vector<REGRESSION_RESULT> results(target_methods.size());
+        outer_pool->parallel_for(target_methods.size(), [&](size_t method_index, uint32_t)
+                                 {
+                                     results[method_index] = this->proceed_robust_fit(target_methods[method_index], irls_setup, inner_pool, false);
+                                     results[method_index].method = target_methods[method_index]; });
+        return results;
     }
 
     /**
@@ -192,8 +298,54 @@ public:
      */
     void set_observed(const std::vector<double> &x_observed, const std::vector<double> &y_observed)
     {
-        this->m_x_observed = x_observed;
-        this->m_y_observed = y_observed;
+        this->set_observed(DATA_SET(x_observed, y_observed));
+    }
+
+    /**
+     * @brief Sets the new data for robust regression computation without copying it.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     */
+    void set_observed(const DATA_SET &observed_data)
+    {
+        this->m_observed_data = observed_data;
+        this->m_is_data_initialized = true;
+    }
+
+    /**
+     * @brief
+     * Restricts the observed data to the data points whose independent variable (X-Axis) lies in [x_low, x_high],
+     * e.g. the last day of a multi-year time series.
+     * Must be used after the observed data is set; get_observed() and the weights refer to the selected data.
+     * @details
+     * The blocks of .dbin data whose range of X-Axis does not overlap the window are skipped without reading them,
+     * so the cost of a fit on sorted data is proportional to the window instead of the file.
+     * It throws a runtime error if the range is invalid or holds no data point.
+     *
+     * @param[in] x_low The lowest independent variable used for the regression.
+     * @param[in] x_high The highest independent variable used for the regression.
+     */
+    void set_x_range(const double x_low, const double x_high)
+    {
+        validate_data_initialization();
+        if ((x_low <= x_high) == false)
+        {
+            std::string error_message =
+                "FACADE REGRESSION ERROR - INVALID X-RANGE\n"
+                "The lower end of the range must not exceed the upper end, but the range is [" +
+                std::to_string(x_low) + ", " + std::to_string(x_high) + "].\n";
+            throw std::runtime_error(error_message);
+        }
+
+        DATA_SET selected_data = this->m_observed_data.select_x_range(x_low, x_high);
+        if (selected_data.empty() == true)
+        {
+            std::string error_message =
+                "FACADE REGRESSION ERROR - NO DATA IN X-RANGE\n"
+                "There is no data point in [" + std::to_string(x_low) + ", " + std::to_string(x_high) + "].\n";
+            throw std::runtime_error(error_message);
+        }
+        this->m_observed_data = std::move(selected_data);
     }
 
     /**
@@ -204,6 +356,46 @@ public:
     void set_method(const REGRESSION_METHOD target_method)
     {
         this->m_target_method = target_method;
+        this->m_is_method_initialized = true;
+    }
+
+    /**
+     * @brief Set the IRLS iteration engine for robust regression computation.
+     * @details FUSED engine with static dispatch is used by default, STANDARD engine is kept for comparison.
+     *
+     * @param target_engine Engine listed in IRLS_ENGINE.
+     */
+    void set_engine(const IRLS_ENGINE target_engine)
+    {
+        this->m_engine = target_engine;
+    }
+
+    /**
+     * @brief
+     * Runs the robust regression on a new thread pool of num_threads threads.
+     * @details
+     * The data is split into chunks of chunk_size data points and
+     * every pass of an IRLS iteration runs over the chunks in parallel.
+     * It is used by IRLS_ENGINE::FUSED only, IRLS_ENGINE::STANDARD always runs on the calling thread.
+     *
+     * @param[in] num_threads The number of threads, zero means the number of hardware threads and one disables parallel mode.
+     * @param[in] chunk_size The number of data points processed by a task, zero means the default size.
+     */
+    void set_parallel(const uint32_t num_threads, const uint32_t chunk_size = 0)
+    {
+        this->set_parallel(std::make_shared<THREAD_POOL>(num_threads), chunk_size);
+    }
+
+    /**
+     * @brief Runs the robust regression on the given thread pool, which can be shared with other objects.
+     *
+     * @param[in] thread_pool Threads used for the computation.
+     * @param[in] chunk_size The number of data points processed by a task, zero means the default size.
+     */
+    void set_parallel(std::shared_ptr<THREAD_POOL> thread_pool, const uint32_t chunk_size = 0)
+    {
+        this->m_thread_pool = std::move(thread_pool);
+        this->m_chunk_size = chunk_size;
     }
 
     /**
@@ -248,17 +440,201 @@ public:
         w_weight = this->m_w_weight;
     }
 
+    /**
+     * @brief
+     * Gets the read-only view of the weight of observed data point without copying it.
+     * The view is valid until the next regression or release_w_weight().
+     *
+     * @return std::span<const double>
+     */
+    std::span<const double> get_w_weight() const
+    {
+        return this->m_w_weight;
+    }
+
+    /**
+     * @brief
+     * Moves the weight of observed data point out of the object without copying it.
+     * The object does not hold the weight after the call.
+     *
+     * @return std::vector<double>
+     */
+    std::vector<double> release_w_weight()
+    {
+        return std::move(this->m_w_weight);
+    }
+
+    /**
+     * @brief Gets the observed data used for robust regression computation, the data is shared not copied.
+     *
+     * @return const DATA_SET&
+     */
+    const DATA_SET &get_observed() const
+    {
+        return this->m_observed_data;
+    }
+
 private:
     REGRESSION_METHOD m_target_method;
+    IRLS_ENGINE m_engine = IRLS_ENGINE::FUSED;
+    std::shared_ptr<THREAD_POOL> m_thread_pool;
+    uint32_t m_chunk_size = 0;
     double m_m_slope;
     double m_b_intercept;
-    std::vector<double> m_x_observed;
-    std::vector<double> m_y_observed;
+    DATA_SET m_observed_data;
     std::vector<double> m_w_weight;
 
     bool m_is_data_initialized;
     bool m_is_method_initialized;
 
+    /**
+     * @brief Perfroms robust regression with REGRESSION_ROBUST derived class chosen at runtime.
+     *
+     */
+    void proceed_regression_dynamic()
+    {
+        REGRESSION_ROBUST *regression = nullptr;
+        switch (this->m_target_method)
+        {
+        case REGRESSION_METHOD::ANDREWS:
+            regression = new M_ESTIMATOR_ANDREWS(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::BISQUARE:
+            regression = new M_ESTIMATOR_BISQUARE(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::CAUCHY:
+            regression = new M_ESTIMATOR_CAUCHY(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::FAIR:
+            regression = new M_ESTIMATOR_FAIR(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::HUBER:
+            regression = new M_ESTIMATOR_HUBER(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::LOGISTIC:
+            regression = new M_ESTIMATOR_LOGISTIC(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::TALWAR:
+            regression = new M_ESTIMATOR_TALWAR(m_observed_data);
+            break;
+
+        case REGRESSION_METHOD::WELSCH:
+            regression = new M_ESTIMATOR_WELSCH(m_observed_data);
+            break;
+
+        default:
+            break;
+        }
+
+        regression->set_engine(this->m_engine);
+        regression->perform_regression();
+
+        m_m_slope = regression->get_slope();
+        m_b_intercept = regression->get_intercept();
+        m_w_weight = regression->release_weight();
+
+        delete regression;
+        regression = nullptr;
+    }
+
+    /**
+     * @brief Perfroms robust regression with ROBUST_FIT specialization of the chosen weight function.
+     *
+     */
+    void proceed_regression_static()
+    {
+        REGRESSION_RESULT result = this->proceed_robust_fit(this->m_target_method, nullptr, m_thread_pool.get(), true);
+
+        m_m_slope = result.m_slope;
+        m_b_intercept = result.b_intercept;
+        m_w_weight = std::move(result.w_weight);
+    }
+
+    /**
+     * @brief Maps the weight function onto ROBUST_FIT specialization and performs robust regression with it.
+     *
+     * @param[in] target_method Weight function listed in REGRESSION_METHOD.
+     * @param[in] irls_setup Setup shared by weight functions, it is computed by ROBUST_FIT if null.
+     * @param[in] thread_pool Threads used by the passes over the data, it can be null.
+     * @param[in] keep_weight Moves the weight into the result if true.
+     * @return REGRESSION_RESULT
+     */
+    REGRESSION_RESULT proceed_robust_fit(
+        const REGRESSION_METHOD target_method,
+        std::shared_ptr<const IRLS_SETUP> irls_setup,
+        THREAD_POOL *thread_pool,
+        const bool keep_weight)
+    {
+        switch (target_method)
+        {
+        case REGRESSION_METHOD::ANDREWS:
+            return this->proceed_robust_fit<M_ESTIMATOR_ANDREWS>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::BISQUARE:
+            return this->proceed_robust_fit<M_ESTIMATOR_BISQUARE>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::CAUCHY:
+            return this->proceed_robust_fit<M_ESTIMATOR_CAUCHY>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::FAIR:
+            return this->proceed_robust_fit<M_ESTIMATOR_FAIR>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::HUBER:
+            return this->proceed_robust_fit<M_ESTIMATOR_HUBER>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::LOGISTIC:
+            return this->proceed_robust_fit<M_ESTIMATOR_LOGISTIC>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::TALWAR:
+            return this->proceed_robust_fit<M_ESTIMATOR_TALWAR>(irls_setup, thread_pool, keep_weight);
+
+        case REGRESSION_METHOD::WELSCH:
+            return this->proceed_robust_fit<M_ESTIMATOR_WELSCH>(irls_setup, thread_pool, keep_weight);
+        }
+        return REGRESSION_RESULT();
+    }
+
+    /**
+     * @brief Perfroms robust regression with ROBUST_FIT<ESTIMATOR> constructed on the stack.
+     *
+     * @tparam ESTIMATOR One of M_ESTIMATOR_* classes.
+     * @param[in] irls_setup Setup shared by weight functions, it is computed by ROBUST_FIT if null.
+     * @param[in] thread_pool Threads used by the passes over the data, it can be null.
+     * @param[in] keep_weight Moves the weight into the result if true.
+     * @return REGRESSION_RESULT
+     */
+    template <typename ESTIMATOR>
+    REGRESSION_RESULT proceed_robust_fit(std::shared_ptr<const IRLS_SETUP> irls_setup, THREAD_POOL *thread_pool, const bool keep_weight)
+    {
+        auto time_start = std::chrono::steady_clock::now();
+
+        ROBUST_FIT<ESTIMATOR> regression = (irls_setup != nullptr)
+                                               ? ROBUST_FIT<ESTIMATOR>(std::move(irls_setup))
+                                               : ROBUST_FIT<ESTIMATOR>(m_observed_data);
+        if (thread_pool != nullptr)
+        {
+            regression.set_parallel(*thread_pool, m_chunk_size);
+        }
+        regression.perform_regression();
+
+        REGRESSION_RESULT result;
+        result.m_slope = regression.get_slope();
+        result.b_intercept = regression.get_intercept();
+        result.num_iteration = regression.get_num_iteration();
+        if (keep_weight == true)
+        {
+            result.w_weight = regression.release_weight();
+        }
+        result.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+        return result;
+    }
+
     /**
      * @brief
      * Validates the data for regression computation is initialized.
@@ -0,0 +1,218 @@
+#pragma once
+#include "regression_basic.hpp"
+#include "data_set.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @class IRLS_SETUP
+ * @brief
+ * IRLS_SETUP class holds the part of robust regression that does not depend on the weight function.
+ *
+ * @details
+ * The following values are computed once from the observed data and
+ * can be shared by ROBUST_FIT objects of different M-estimators running on the same data.
+ * - means of observed data, used as the reference point of weighted sums
+ * - sum of squares of observed data's Y-Axis
+ * - leverage of observed data, with the sum of squares of X-Axis accumulated around its mean
+ * - weighted sums of the first iteration, where the weight is 1 / pow(observed data's Y-Axis, 2)
+ * The sums are taken from the statistics stored with the data, e.g. in .dbin file, when they are known;
+ * then only the leverage and the weighted sums read the data.
+ * IRLS_SETUP object is immutable after the construction; therefore,
+ * it can be read by multiple threads at the same time.
+ */
+class IRLS_SETUP
+{
+public:
+    /**
+     * @brief
+     * Constructs a new IRLS_SETUP object and computes the values from the given data.
+     * If thread pool is given, the data is split into chunks and processed in parallel.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] thread_pool Threads used for the computation, it can be null.
+     * @param[in] chunk_size The number of data points processed by a task.
+     */
+    IRLS_SETUP(const DATA_SET &observed_data, THREAD_POOL *thread_pool = nullptr, const uint32_t chunk_size = 8192)
+        : m_observed_data(observed_data)
+    {
+        std::span<const double> x_observed = observed_data.get_x();
+        std::span<const double> y_observed = observed_data.get_y();
+        const size_t num_data_points = observed_data.size();
+        const size_t num_chunks = count_chunks(num_data_points, chunk_size);
+
+        DATA_SUMS total_sums;
+        if (observed_data.get_stats() != nullptr)
+        {
+            const DATA_STATS &data_stats = observed_data.get_stats()->total;
+            total_sums = DATA_SUMS{data_stats.x_sum, data_stats.y_sum, data_stats.yy_sum};
+        }
+        else
+        {
+            total_sums = sum_data(observed_data, thread_pool, chunk_size);
+        }
+        this->m_x_mean = total_sums.x_sum / static_cast<double>(num_data_points);
+        this->m_y_mean = total_sums.y_sum / static_cast<double>(num_data_points);
+        this->m_yy_sum = total_sums.yy_sum;
+
+        this->m_h_leverage = std::vector<double>(num_data_points, 0);
+        std::vector<WEIGHTED_SUMS> partial_sums(num_chunks);
+        std::vector<double> partial_xx_sums(num_chunks);
+        const double x_mean = this->m_x_mean;
+        const double y_mean = this->m_y_mean;
+        run_chunks(thread_pool, num_data_points, chunk_size,
+                   [&](size_t chunk_begin, size_t chunk_end, size_t chunk_index)
+                   {
+                       WEIGHTED_SUMS temp_sums;
+                       double temp_xx_sum = 0.0;
+                       for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                       {
+                           double dx = x_observed[iter] - x_mean;
+                           double dy = y_observed[iter] - y_mean;
+                           double w = 1.0 / (y_observed[iter] * y_observed[iter]);
+                           m_h_leverage[iter] = dx * dx;
+                           temp_xx_sum += dx * dx;
+                           temp_sums.w_sum += w;
+                           temp_sums.wx_sum += w * dx;
+                           temp_sums.wy_sum += w * dy;
+                           temp_sums.wxx_sum += w * dx * dx;
+                           temp_sums.wxy_sum += w * dx * dy;
+                       }
+                       partial_sums[chunk_index] = temp_sums;
+                       partial_xx_sums[chunk_index] = temp_xx_sum;
+                   });
+        double centered_xx_sum = 0.0;
+        for (size_t iter = 0; iter < num_chunks; iter++)
+        {
+            this->m_initial_sums.merge(partial_sums[iter]);
+            centered_xx_sum += partial_xx_sums[iter];
+        }
+
+        // the leverage needs the sum of pow(x - x_mean, 2) of the whole data, so it is scaled after the sums are merged
+        const double inverse_num_points = 1.0 / static_cast<double>(num_data_points);
+        run_chunks(thread_pool, num_data_points, chunk_size,
+                   [&](size_t chunk_begin, size_t chunk_end, size_t)
+                   {
+                       for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                       {
+                           m_h_leverage[iter] = inverse_num_points + (m_h_leverage[iter] / centered_xx_sum);
+                       }
+                   });
+    }
+
+    ~IRLS_SETUP() {}
+
+    /**
+     * @brief Gets the observed data the values are computed from.
+     *
+     * @return const DATA_SET&
+     */
+    const DATA_SET &get_observed() const
+    {
+        return this->m_observed_data;
+    }
+
+    /**
+     * @brief Gets the average of observed data's independent variables (X-Axis).
+     *
+     * @return double
+     */
+    double get_x_mean() const
+    {
+        return this->m_x_mean;
+    }
+
+    /**
+     * @brief Gets the average of observed data's dependent variables (Y-Axis).
+     *
+     * @return double
+     */
+    double get_y_mean() const
+    {
+        return this->m_y_mean;
+    }
+
+    /**
+     * @brief Gets the sum of pow(observed data's Y-Axis, 2), the residual sum before the first iteration.
+     *
+     * @return double
+     */
+    double get_yy_sum() const
+    {
+        return this->m_yy_sum;
+    }
+
+    /**
+     * @brief Gets the weighted sums of the first iteration, shifted by the means.
+     *
+     * @return const WEIGHTED_SUMS&
+     */
+    const WEIGHTED_SUMS &get_initial_sums() const
+    {
+        return this->m_initial_sums;
+    }
+
+    /**
+     * @brief Gets the read-only view of observed data's leverage.
+     *
+     * @return std::span<const double>
+     */
+    std::span<const double> get_leverage() const
+    {
+        return this->m_h_leverage;
+    }
+
+private:
+    /**
+     * @brief Sums of observed data required to start the regression.
+     *
+     */
+    struct DATA_SUMS
+    {
+        double x_sum = 0.0;
+        double y_sum = 0.0;
+        double yy_sum = 0.0;
+    };
+
+    /**
+     * @brief Computes the sums of observed data, split into chunks if thread pool is given.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] thread_pool Threads used for the computation, it can be null.
+     * @param[in] chunk_size The number of data points processed by a task.
+     * @return DATA_SUMS
+     */
+    static DATA_SUMS sum_data(const DATA_SET &observed_data, THREAD_POOL *thread_pool, const uint32_t chunk_size)
+    {
+        std::span<const double> x_observed = observed_data.get_x();
+        std::span<const double> y_observed = observed_data.get_y();
+        const size_t num_data_points = observed_data.size();
+        std::vector<DATA_SUMS> data_sums(count_chunks(num_data_points, chunk_size));
+        run_chunks(thread_pool, num_data_points, chunk_size,
+                   [&](size_t chunk_begin, size_t chunk_end, size_t chunk_index)
+                   {
+                       DATA_SUMS temp_sums;
+                       for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                       {
+                           temp_sums.x_sum += x_observed[iter];
+                           temp_sums.y_sum += y_observed[iter];
+                           temp_sums.yy_sum += y_observed[iter] * y_observed[iter];
+                       }
+                       data_sums[chunk_index] = temp_sums;
+                   });
+        DATA_SUMS total_sums;
+        for (const auto &chunk_sums : data_sums)
+        {
+            total_sums.x_sum += chunk_sums.x_sum;
+            total_sums.y_sum += chunk_sums.y_sum;
+            total_sums.yy_sum += chunk_sums.yy_sum;
+        }
+        return total_sums;
+    }
+
+    DATA_SET m_observed_data;
+    double m_x_mean = 0.0;
+    double m_y_mean = 0.0;
+    double m_yy_sum = 0.0;
+    WEIGHTED_SUMS m_initial_sums;
+    std::vector<double> m_h_leverage;
+};
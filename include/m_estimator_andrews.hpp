@@ -26,11 +26,67 @@ public:
         this->tunning_constant = (custom_tunning == 0) ? default_tunning_constant : custom_tunning;
     }
 
+    /**
+     * @brief Constructs ROBUST_REGRESSION object with weight function driven from Andrew M-Estimator.
+     * The observed data is shared with the given DATA_SET object without copying it.
+     *
+     * @param observed_data A collection of observed data points.
+     * @param custom_tunning Tunning constant, by default predefined value will be used.
+     */
+    M_ESTIMATOR_ANDREWS(const DATA_SET &observed_data, double custom_tunning = 0)
+        : REGRESSION_ROBUST(observed_data)
+    {
+        this->tunning_constant = (custom_tunning == 0) ? default_tunning_constant : custom_tunning;
+    }
+
     ~M_ESTIMATOR_ANDREWS() {}
 
+    /**
+     * @brief Predefined tunning constant, used when custom tunning constant is not given.
+     *
+     */
+    static constexpr double default_tunning_constant = 1.339;
+
+    /**
+     * @brief Computes weight of a data point from its standardized residual.
+     * @details
+     * sin(r) / r is computed by simd_sin_over_x(), and the result is masked to zero for |r| >= pi.
+     *
+     * @param[in] r_standardized A standardized residual of a data point.
+     * @return double
+     */
+    static double weight_function(const double r_standardized)
+    {
+        return (std::abs(r_standardized) < std::numbers::pi) ? simd_sin_over_x(r_standardized) : 0.0;
+    }
+
+    /**
+     * @brief
+     * Computes weight of observed data points in a single pass without temporary storage.
+     * The loop is vectorized, and the instruction set is chosen at startup by SIMD_DISPATCH.
+     *
+     * @param[in] residual A collection of raw residual.
+     * @param[in] leverage A leverage value collection.
+     * @param[in] const_val A product of tunning constant and estimated standard deviation of the error term.
+     * @param[out] weight A collection of weight of observed data computed.
+     * @param[in] num_elements The number of observed data points.
+     */
+    SIMD_DISPATCH static void compute_weight_kernel(
+        const double *residual,
+        const double *leverage,
+        const double const_val,
+        double *weight,
+        const uint32_t num_elements)
+    {
+        for (uint32_t i = 0; i < num_elements; i++)
+        {
+            double r_standardized = residual[i] / (const_val * std::sqrt(1.0 - leverage[i]));
+            weight[i] = weight_function(r_standardized);
+        }
+    }
+
 private:
     double tunning_constant = 1;
-    const double default_tunning_constant = 1.339;
 
     /**
      * @brief Computes weight of observed data points.
@@ -48,15 +104,6 @@ private:
     {
         // s = estimate of the standard deviation of the error term = val_MAD / 0.6745
         double const_val = tunning_constant * val_MAD / 0.6745;
-        std::vector<double> r_standardized(residual.size(), 0);
-        for (uint32_t i = 0; i < residual.size(); i++)
-        {
-            r_standardized[i] = residual[i] / (const_val * std::sqrt(1.0 - leverage[i]));
-        }
-
-        for (uint32_t i = 0; i < residual.size(); i++)
-        {
-            weight[i] = (std::abs(r_standardized[i]) < std::numbers::pi) ? std::sin(r_standardized[i]) / r_standardized[i] : 0;
-        }
+        compute_weight_kernel(residual.data(), leverage.data(), const_val, weight.data(), static_cast<uint32_t>(residual.size()));
     }
 };
\ No newline at end of file
@@ -0,0 +1,246 @@
+/**
+ * The file contains read-only memory mapping of a file used by the fast loading methods.
+ */
+#pragma once
+#include "PCH.hpp"
+#include "standard_stream.hpp"
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class MAPPED_FILE
+ * @brief
+ * MAPPED_FILE class maps a whole file into memory for reading and unmaps it on destruction.
+ *
+ * @details
+ * The content of the file is accessed through get_view() without copying it into a buffer;
+ * the operating system loads the pages on first access and can read ahead as the file is read in order.
+ * An empty file is not mapped, and its view is empty.
+ * The file name standard_stream_name ("-") denotes the standard input; it is mapped if it is redirected from a file,
+ * and otherwise, e.g. a pipe, it is read to the end into a buffer that grows geometrically.
+ * MAPPED_FILE object can be moved but not copied.
+ */
+class MAPPED_FILE
+{
+public:
+    /**
+     * @brief Constructs a new MAPPED_FILE object and maps the file read-only.
+     * It throws a runtime exception if the file cannot be opened or mapped.
+     *
+     * @param[in] file_name Path to the file to be mapped.
+     */
+    explicit MAPPED_FILE(const std::string &file_name)
+    {
+        if (is_standard_stream(file_name) == true)
+        {
+            this->load_standard_input();
+            return;
+        }
+#if defined(_WIN32)
+        HANDLE file_handle = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            throw_map_error(file_name);
+        }
+        LARGE_INTEGER file_size;
+        if (GetFileSizeEx(file_handle, &file_size) == 0)
+        {
+            CloseHandle(file_handle);
+            throw_map_error(file_name);
+        }
+        this->m_size = static_cast<size_t>(file_size.QuadPart);
+        if (this->m_size > 0)
+        {
+            HANDLE mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_handle != nullptr)
+            {
+                this->m_data = static_cast<const char *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping_handle);
+            }
+        }
+        CloseHandle(file_handle);
+#else
+        int file_descriptor = open(file_name.c_str(), O_RDONLY);
+        if (file_descriptor < 0)
+        {
+            throw_map_error(file_name);
+        }
+        struct stat file_status;
+        if (fstat(file_descriptor, &file_status) != 0)
+        {
+            close(file_descriptor);
+            throw_map_error(file_name);
+        }
+        this->m_size = static_cast<size_t>(file_status.st_size);
+        if (this->m_size > 0)
+        {
+            void *mapped_address = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+            if (mapped_address != MAP_FAILED)
+            {
+                this->m_data = static_cast<const char *>(mapped_address);
+                madvise(mapped_address, this->m_size, MADV_SEQUENTIAL);
+            }
+        }
+        close(file_descriptor);
+#endif
+        if (this->m_size > 0 && this->m_data == nullptr)
+        {
+            throw_map_error(file_name);
+        }
+    }
+
+    MAPPED_FILE(const MAPPED_FILE &) = delete;
+    MAPPED_FILE &operator=(const MAPPED_FILE &) = delete;
+
+    MAPPED_FILE(MAPPED_FILE &&other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+          m_buffer(std::move(other.m_buffer))
+    {
+    }
+
+    MAPPED_FILE &operator=(MAPPED_FILE &&other) noexcept
+    {
+        if (this != &other)
+        {
+            this->unmap();
+            this->m_data = std::exchange(other.m_data, nullptr);
+            this->m_size = std::exchange(other.m_size, 0);
+            this->m_buffer = std::move(other.m_buffer);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Unmaps the file.
+     *
+     */
+    ~MAPPED_FILE()
+    {
+        this->unmap();
+    }
+
+    /**
+     * @brief Gets the read-only view of the whole file, valid while the object exists.
+     *
+     * @return std::string_view
+     */
+    std::string_view get_view() const
+    {
+        if (this->m_buffer.empty() == false)
+        {
+            return std::string_view(this->m_buffer.data(), this->m_buffer.size());
+        }
+        return (this->m_data == nullptr) ? std::string_view() : std::string_view(this->m_data, this->m_size);
+    }
+
+    /**
+     * @brief Gets the size of the file in bytes.
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        return this->m_size;
+    }
+
+private:
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<char> m_buffer; // content of the standard input that cannot be mapped
+
+    /**
+     * @brief
+     * Maps the standard input if it is a regular file read from the beginning, or
+     * otherwise reads it to the end into the buffer.
+     * It throws a runtime exception if it cannot be read.
+     *
+     */
+    void load_standard_input()
+    {
+        set_binary_mode(stdin);
+#if !defined(_WIN32)
+        struct stat file_status;
+        if (fstat(STDIN_FILENO, &file_status) == 0 && S_ISREG(file_status.st_mode) && lseek(STDIN_FILENO, 0, SEEK_CUR) == 0)
+        {
+            this->m_size = static_cast<size_t>(file_status.st_size);
+            if (this->m_size > 0)
+            {
+                void *mapped_address = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, STDIN_FILENO, 0);
+                if (mapped_address == MAP_FAILED)
+                {
+                    throw_map_error(standard_stream_name);
+                }
+                this->m_data = static_cast<const char *>(mapped_address);
+                madvise(mapped_address, this->m_size, MADV_SEQUENTIAL);
+            }
+            return;
+        }
+#endif
+        constexpr size_t initial_buffer_bytes = size_t(1) << 20;
+        this->m_buffer.resize(initial_buffer_bytes);
+        size_t num_read = 0;
+        while (true)
+        {
+            if (num_read == this->m_buffer.size())
+            {
+                this->m_buffer.resize(this->m_buffer.size() * 2);
+            }
+            size_t num_new = std::fread(this->m_buffer.data() + num_read, 1, this->m_buffer.size() - num_read, stdin);
+            num_read += num_new;
+            if (num_new == 0)
+            {
+                break;
+            }
+        }
+        if (std::ferror(stdin) != 0)
+        {
+            throw_map_error(standard_stream_name);
+        }
+        this->m_buffer.resize(num_read);
+        this->m_size = num_read;
+    }
+
+    /**
+     * @brief Releases the mapping if the file is mapped.
+     *
+     */
+    void unmap()
+    {
+        if (this->m_data == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(this->m_data);
+#else
+        munmap(const_cast<char *>(this->m_data), this->m_size);
+#endif
+        this->m_data = nullptr;
+    }
+
+    /**
+     * @brief Throws a runtime exception for a file that cannot be mapped.
+     *
+     * @param[in] file_name Path to the file failed to be mapped.
+     */
+    [[noreturn]] static void throw_map_error(const std::string &file_name)
+    {
+        std::string error_message =
+            "READ ERROR - FAILED TO MAP A FILE.\n"
+            "Please check " + file_name + " is correct.\n";
+        throw std::runtime_error(error_message);
+    }
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "PCH.hpp"
+#include <span>
 
 /**
  * @brief
@@ -57,8 +58,8 @@ public:
      * @param[out] y_inlier A collection of inliers in observed data's dependent variables (Y-Axis).
      */
     void detection_by_standardized_residual(
-        const std::vector<double> &x_observed,
-        const std::vector<double> &y_observed,
+        std::span<const double> x_observed,
+        std::span<const double> y_observed,
         const double m_slope,
         const double b_intercept,
         uint32_t &num_detectded_outlier,
@@ -101,8 +102,8 @@ public:
     void compute_standardized_residual(
         const double m_slope,
         const double b_intercept,
-        const std::vector<double> &x_observed,
-        const std::vector<double> &y_observed,
+        std::span<const double> x_observed,
+        std::span<const double> y_observed,
         std::vector<double> &standardized_residual)
     {
         validate_vector_length_match(x_observed, y_observed);
@@ -145,9 +146,9 @@ public:
      * @param[out] y_inlier A collection of inliers in observed data's dependent variables (Y-Axis).
      */
     void detection_by_weight(
-        const std::vector<double> &x_observed,
-        const std::vector<double> &y_observed,
-        const std::vector<double> &w_weight,
+        std::span<const double> x_observed,
+        std::span<const double> y_observed,
+        std::span<const double> w_weight,
         uint32_t &num_detectded_outlier,
         std::vector<double> &x_outlier,
         std::vector<double> &y_outlier,
@@ -184,7 +185,7 @@ private:
      * @return double
      */
     double compute_RMSE(
-        const std::vector<double> &r_residual,
+        std::span<const double> r_residual,
         const uint32_t num_parameter)
     {
         double temp_result = 0.0;
@@ -209,8 +210,8 @@ private:
     void compute_raw_residual(
         const double m_slope,
         const double b_intercept,
-        const std::vector<double> &x_observed,
-        const std::vector<double> &y_observed,
+        std::span<const double> x_observed,
+        std::span<const double> y_observed,
         std::vector<double> &raw_residual)
     {
         validate_vector_length_match(x_observed, y_observed);
@@ -236,14 +237,14 @@ private:
      * @param[out] h_leverage A leverage value collection.
      */
     void compute_leverage(
-        const std::vector<double> &x_observed,
+        std::span<const double> x_observed,
         std::vector<double> h_leverage)
     {
         validate_vector_length_match(x_observed, h_leverage);
 
         uint32_t num_elements = static_cast<uint32_t>(x_observed.size());
         double x_mean = 0.0;
-        x_mean = std::accumulate(x_observed.cbegin(), x_observed.cend(), 0.0);
+        x_mean = std::accumulate(x_observed.begin(), x_observed.end(), 0.0);
         x_mean = x_mean / num_elements;
 
         double xx_sum = 0.0;
@@ -266,7 +267,7 @@ private:
      * @param vec_one collection of independent variables
      * @param vec_two collection of independent variables
      */
-    void validate_vector_length_match(const std::vector<double> &vec_one, const std::vector<double> &vec_two)
+    void validate_vector_length_match(std::span<const double> vec_one, std::span<const double> vec_two)
     {
         if (vec_one.size() != vec_two.size())
         {
@@ -1,5 +1,6 @@
 #pragma once
 #include "bmp_out.hpp"
+#include "data_set.hpp"
 
 /**
  * @brief
@@ -35,9 +36,27 @@ public:
      * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
      * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
      */
-    OUTLIER_PLOT(const std::vector<double> &x_observed, const std::vector<double> &y_observed) : m_x_observed(x_observed), m_y_observed(y_observed)
+    OUTLIER_PLOT(std::span<const double> x_observed, std::span<const double> y_observed)
     {
-        this->init_image();
+        this->init_image(x_observed, y_observed);
+    }
+
+    /**
+     * @brief
+     * The constructor constructs a new OUTLIER_PLOT object, and
+     * initializes the size of the image to be generated from the given data points without copying them.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     */
+    OUTLIER_PLOT(const DATA_SET &observed_data)
+    {
+        if (observed_data.get_stats() != nullptr)
+        {
+            set_dimension(observed_data.get_stats()->total);
+            plot_result.set_size(m_graph_width, m_graph_height);
+            return;
+        }
+        this->init_image(observed_data.get_x(), observed_data.get_y());
     }
 
     /**
@@ -104,7 +123,7 @@ public:
      * @param marker_colour RGB colour data to define colour of the point.
      * @param marker_radius Radius of marker to be drawn in pixel unit. If the value is zero, the size would be 1 pixel.
      */
-    void draw_data_points(const std::vector<double> &arr_x, const std::vector<double> &arr_y, const RGB_COLOUR &marker_colour, const uint32_t marker_radius)
+    void draw_data_points(std::span<const double> arr_x, std::span<const double> arr_y, const RGB_COLOUR &marker_colour, const uint32_t marker_radius)
     {
         validate_vector_length_match(arr_x, arr_y);
 
@@ -132,8 +151,6 @@ private:
 
     BMP_OUT plot_result;
 
-    std::vector<double> m_x_observed;
-    std::vector<double> m_y_observed;
     uint32_t m_graph_width;
     uint32_t m_graph_height;
     double m_actual_width;
@@ -151,7 +168,7 @@ private:
      * @param[in] input_vec A collection of number.
      * @return double
      */
-    double get_min_value(const std::vector<double> &input_vec)
+    double get_min_value(std::span<const double> input_vec)
     {
         double curr_min = input_vec[0];
         for (const auto &element : input_vec)
@@ -167,7 +184,7 @@ private:
      * @param[in] input_vec A collection of number.
      * @return double
      */
-    double get_max_value(const std::vector<double> &input_vec)
+    double get_max_value(std::span<const double> input_vec)
     {
         double curr_max = input_vec[0];
         for (const auto &element : input_vec)
@@ -239,7 +256,7 @@ private:
      * @param[in] x_observed A collection of observed data's X-Axis.
      * @param[in] y_observed A collection of observed data's Y-Axis.
      */
-    void set_dimension(const std::vector<double> &x_observed, const std::vector<double> &y_observed)
+    void set_dimension(std::span<const double> x_observed, std::span<const double> y_observed)
     {
         validate_vector_length_match(x_observed, y_observed);
 
@@ -247,7 +264,31 @@ private:
         m_x_max = get_max_value(x_observed);
         m_y_min = get_min_value(y_observed);
         m_y_max = get_max_value(y_observed);
+        set_graph_size();
+    }
+
+    /**
+     * @brief
+     * Compute values requires for image size initialization from the range in the statistics of observed data
+     * instead of scanning the data.
+     *
+     * @param[in] data_stats Statistics of observed data.
+     */
+    void set_dimension(const DATA_STATS &data_stats)
+    {
+        m_x_min = data_stats.x_min;
+        m_x_max = data_stats.x_max;
+        m_y_min = data_stats.y_min;
+        m_y_max = data_stats.y_max;
+        set_graph_size();
+    }
 
+    /**
+     * @brief Computes the zero position and the size of the image from the range of the data.
+     *
+     */
+    void set_graph_size()
+    {
         m_zero_pos_x = compute_zero_position(m_x_min, m_x_max);
         m_zero_pos_y = compute_zero_position(m_y_min, m_y_max);
 
@@ -337,10 +378,12 @@ private:
     /**
      * @brief Initializes size of output image based on computed dimension data.
      *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
      */
-    void init_image()
+    void init_image(std::span<const double> x_observed, std::span<const double> y_observed)
     {
-        set_dimension(m_x_observed, m_y_observed);
+        set_dimension(x_observed, y_observed);
         plot_result.set_size(m_graph_width, m_graph_height);
     }
 
@@ -352,7 +395,7 @@ private:
      * @param vec_one collection of independent variables
      * @param vec_two collection of independent variables
      */
-    void validate_vector_length_match(const std::vector<double> &vec_one, const std::vector<double> &vec_two)
+    void validate_vector_length_match(std::span<const double> vec_one, std::span<const double> vec_two)
     {
         if (vec_one.size() != vec_two.size())
         {
@@ -1,5 +1,37 @@
 #pragma once
 #include "PCH.hpp"
+#include "thread_pool.hpp"
+#include "data_stats.hpp"
+#include <span>
+
+/**
+ * @brief
+ * Weighted sufficient statistics of observed data for weighted least square regression.
+ * The sums are accumulated after the observed data are shifted by a reference point (usually their means)
+ * to avoid cancellation when the slope is computed from them.
+ */
+struct WEIGHTED_SUMS
+{
+    double w_sum = 0.0;
+    double wx_sum = 0.0;
+    double wy_sum = 0.0;
+    double wxx_sum = 0.0;
+    double wxy_sum = 0.0;
+
+    /**
+     * @brief Adds the sums of another part of the same data, used to combine partial sums of chunks.
+     *
+     * @param[in] other Weighted sums of another part of the data, shifted by the same reference point.
+     */
+    void merge(const WEIGHTED_SUMS &other)
+    {
+        w_sum += other.w_sum;
+        wx_sum += other.wx_sum;
+        wy_sum += other.wy_sum;
+        wxx_sum += other.wxx_sum;
+        wxy_sum += other.wxy_sum;
+    }
+};
 
 /**
  * @brief
@@ -33,8 +65,8 @@ public:
      * @param[out] b_intercept An approximated intercept of linear system.
      */
     void ols_regression(
-        const std::vector<double> &arr_x,
-        const std::vector<double> &arr_y,
+        std::span<const double> arr_x,
+        std::span<const double> arr_y,
         double &m_slope, double &b_intercept)
     {
 
@@ -48,6 +80,46 @@ public:
         b_intercept = (y_sum - m_slope * x_sum) / num_points;
     }
 
+    /**
+     * @brief
+     * Performs Ordinary Least Square regression with the sums of the statistics of observed data
+     * instead of reading the data.
+     *
+     * @param[in] data_stats Statistics of observed data.
+     * @param[out] m_slope An approximated slope of linear system.
+     * @param[out] b_intercept An approximated intercept of linear system.
+     */
+    void ols_regression(const DATA_STATS &data_stats, double &m_slope, double &b_intercept)
+    {
+        double num_points = static_cast<double>(data_stats.num_points);
+        m_slope = (num_points * data_stats.xy_sum - data_stats.x_sum * data_stats.y_sum) /
+                  (num_points * data_stats.xx_sum - std::pow(data_stats.x_sum, 2));
+        b_intercept = (data_stats.y_sum - m_slope * data_stats.x_sum) / num_points;
+    }
+
+    /**
+     * @brief Computes parameters of weighted least square line of best fit from weighted sums.
+     *
+     * @param[in] weighted_sums Weighted sums of the observed data shifted by (x_shift, y_shift).
+     * @param[in] x_shift A value subtracted from observed data's X-Coordinate before accumulation.
+     * @param[in] y_shift A value subtracted from observed data's Y-Coordinate before accumulation.
+     * @param[out] m_slope An approximated slope of linear system.
+     * @param[out] b_intercept An approximated intercept of linear system.
+     */
+    void wls_from_sums(
+        const WEIGHTED_SUMS &weighted_sums,
+        const double x_shift,
+        const double y_shift,
+        double &m_slope, double &b_intercept)
+    {
+        double x_weight = weighted_sums.wx_sum / weighted_sums.w_sum;
+        double y_weight = weighted_sums.wy_sum / weighted_sums.w_sum;
+        double temp_wxy = weighted_sums.wxy_sum - weighted_sums.wx_sum * y_weight;
+        double temp_wxx = weighted_sums.wxx_sum - weighted_sums.wx_sum * x_weight;
+        m_slope = temp_wxy / temp_wxx;
+        b_intercept = (y_shift + y_weight) - (m_slope * (x_shift + x_weight));
+    }
+
     /**
      * @brief Computes predicted data (Y-Axis) of linear system based on
      * - approximated slope
@@ -62,8 +134,8 @@ public:
     void compute_predict(
         const double m_slope,
         const double b_intercept,
-        const std::vector<double> &x_observed,
-        std::vector<double> &y_predicted)
+        std::span<const double> x_observed,
+        std::span<double> y_predicted)
     {
         for (uint32_t iter = 0; iter < y_predicted.size(); iter++)
         {
@@ -77,9 +149,9 @@ public:
      * @param[in] arr A collection of number elements
      * @return double
      */
-    double compute_arr_sum(const std::vector<double> &arr)
+    double compute_arr_sum(std::span<const double> arr)
     {
-        double sum_array = std::accumulate(arr.cbegin(), arr.cend(), 0.0);
+        double sum_array = std::accumulate(arr.begin(), arr.end(), 0.0);
         return sum_array;
     }
 
@@ -89,7 +161,7 @@ public:
      * @param[in] arr A collection of number elements
      * @return double
      */
-    double compute_xx_sum(const std::vector<double> &arr)
+    double compute_xx_sum(std::span<const double> arr)
     {
         double temp_sum = 0.0;
         for (uint32_t i = 0; i < arr.size(); i++)
@@ -106,9 +178,9 @@ public:
      * @param[in] arr_y Input array two
      * @return double
      */
-    double compute_xy_sum(const std::vector<double> &arr_x, const std::vector<double> &arr_y)
+    double compute_xy_sum(std::span<const double> arr_x, std::span<const double> arr_y)
     {
-        double sum_array = std::inner_product(arr_x.cbegin(), arr_x.cend(), arr_y.cbegin(), 0.0);
+        double sum_array = std::inner_product(arr_x.begin(), arr_x.end(), arr_y.begin(), 0.0);
         return sum_array;
     }
 
@@ -118,9 +190,9 @@ public:
      * @param[in] input_arr A collection of number elements
      * @return double
      */
-    double compute_MEAN(const std::vector<double> &input_arr)
+    double compute_MEAN(std::span<const double> input_arr)
     {
-        double sum_array = std::accumulate(input_arr.cbegin(), input_arr.cend(), 0);
+        double sum_array = std::accumulate(input_arr.begin(), input_arr.end(), 0.0);
         return sum_array / static_cast<double>(input_arr.size());
     }
 
@@ -130,7 +202,7 @@ public:
      * @param[in] input_arr A collection of sorted number elements
      * @return double
      */
-    double compute_MEDIAN(const std::vector<double> &input_arr)
+    double compute_MEDIAN(std::span<const double> input_arr)
     {
         uint32_t num_elements = static_cast<uint32_t>(static_cast<uint32_t>(input_arr.size()));
         double result = 0.0;
@@ -145,26 +217,190 @@ public:
         return result;
     }
 
+    /**
+     * @brief Computes the median value of the input array by selection instead of sorting.
+     * @details
+     * The function partially reorders the given array with std::nth_element,
+     * which takes O(n) time on average, so the input array must be a scratch copy.
+     *
+     * @param[in,out] input_arr A collection of number elements, the order is not preserved.
+     * @return double
+     */
+    double compute_MEDIAN_select(std::vector<double> &input_arr)
+    {
+        if (input_arr.empty() == true)
+        {
+            return 0.0;
+        }
+
+        auto upper_mid = input_arr.begin() + static_cast<std::ptrdiff_t>(input_arr.size() / 2);
+        std::nth_element(input_arr.begin(), upper_mid, input_arr.end());
+        double result = *upper_mid;
+        if (input_arr.size() % 2 == 0)
+        {
+            // every element before upper_mid is not greater than it, so the lower middle is their maximum.
+            double lower_mid = *std::max_element(input_arr.begin(), upper_mid);
+            result = (lower_mid + result) / 2.0;
+        }
+        return result;
+    }
+
     /**
      * @brief Computes the median absolute deviation value of array.
+     * @details
+     * MAD = median(|x_i - median(x)|)
+     * Both medians are found by selection on the scratch buffer owned by the object;
+     * therefore, the function does not allocate memory once the buffer has grown to the size of the input.
      *
      * @param[in] input_arr A collection of number elements
      * @return double
      */
-    double compute_MAD(const std::vector<double> &input_arr)
+    double compute_MAD(std::span<const double> input_arr)
+    {
+        m_selection_buffer.assign(input_arr.begin(), input_arr.end());
+        return this->compute_MAD_in_place(m_selection_buffer);
+    }
+
+    /**
+     * @brief Computes the median absolute deviation value of array without copying it.
+     *
+     * @param[in,out] scratch_arr A collection of number elements, it is overwritten with absolute deviations.
+     * @return double
+     */
+    double compute_MAD_in_place(std::vector<double> &scratch_arr)
+    {
+        double median_val = this->compute_MEDIAN_select(scratch_arr);
+
+        for (auto &update_arr : scratch_arr)
+        {
+            update_arr = std::abs(update_arr - median_val);
+        }
+
+        return this->compute_MEDIAN_select(scratch_arr);
+    }
+
+    /**
+     * @brief Computes the median value of the input array by parallel selection.
+     * @details
+     * Two pivots are chosen from a sorted sample around the median rank.
+     * The elements between the pivots are counted and gathered chunk by chunk over the thread pool,
+     * and only the gathered band, usually a small fraction of the input, is searched by std::nth_element.
+     * If the median falls outside of the band, or the input is smaller than two chunks,
+     * compute_MEDIAN_select() is used instead.
+     * The input array is not reordered unless compute_MEDIAN_select() is used.
+     *
+     * @param[in] thread_pool Threads used for the computation.
+     * @param[in] chunk_size The number of elements processed by a task.
+     * @param[in,out] input_arr A collection of number elements, the order may not be preserved.
+     * @return double
+     */
+    double compute_MEDIAN_parallel(THREAD_POOL &thread_pool, const size_t chunk_size, std::vector<double> &input_arr)
     {
+        const size_t num_elements = input_arr.size();
+        if (thread_pool.get_num_threads() == 1 || num_elements < 2 * chunk_size)
+        {
+            return this->compute_MEDIAN_select(input_arr);
+        }
 
-        std::vector<double> sorted_arr(input_arr);
-        std::sort(sorted_arr.begin(), sorted_arr.end());
+        const size_t rank_upper = num_elements / 2;
+        const size_t rank_lower = (num_elements % 2 == 0) ? rank_upper - 1 : rank_upper;
 
-        double median_val = this->compute_MEDIAN(sorted_arr);
+        const size_t num_samples = std::min<size_t>(num_elements, 8192);
+        std::vector<double> &samples = this->m_band_buffer;
+        samples.resize(num_samples);
+        for (size_t iter = 0; iter < num_samples; iter++)
+        {
+            samples[iter] = input_arr[iter * num_elements / num_samples];
+        }
+        std::sort(samples.begin(), samples.end());
 
-        for (auto update_arr : sorted_arr)
+        const size_t margin = 4 * static_cast<size_t>(std::sqrt(static_cast<double>(num_samples))) + 1;
+        const size_t sample_lower = rank_lower * num_samples / num_elements;
+        const size_t sample_upper = rank_upper * num_samples / num_elements;
+        const double pivot_lower = samples[(sample_lower > margin) ? sample_lower - margin : 0];
+        const double pivot_upper = samples[std::min(sample_upper + margin, num_samples - 1)];
+
+        const size_t num_chunks = THREAD_POOL::get_num_chunks(num_elements, chunk_size);
+        std::vector<size_t> num_below(num_chunks, 0);
+        std::vector<size_t> num_band(num_chunks, 0);
+        thread_pool.parallel_for_chunks(
+            num_elements, chunk_size,
+            [&](size_t chunk_begin, size_t chunk_end, size_t chunk_index, uint32_t)
+            {
+                size_t below = 0;
+                size_t band = 0;
+                for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                {
+                    below += (input_arr[iter] < pivot_lower) ? 1 : 0;
+                    band += (input_arr[iter] >= pivot_lower && input_arr[iter] <= pivot_upper) ? 1 : 0;
+                }
+                num_below[chunk_index] = below;
+                num_band[chunk_index] = band;
+            });
+
+        size_t total_below = std::accumulate(num_below.cbegin(), num_below.cend(), size_t(0));
+        std::vector<size_t> band_offset(num_chunks, 0);
+        size_t total_band = 0;
+        for (size_t iter = 0; iter < num_chunks; iter++)
         {
-            update_arr = update_arr - median_val;
+            band_offset[iter] = total_band;
+            total_band += num_band[iter];
         }
+        if (rank_lower < total_below || rank_upper >= total_below + total_band)
+        {
+            return this->compute_MEDIAN_select(input_arr);
+        }
+
+        std::vector<double> &band = this->m_band_buffer;
+        band.resize(total_band);
+        thread_pool.parallel_for_chunks(
+            num_elements, chunk_size,
+            [&](size_t chunk_begin, size_t chunk_end, size_t chunk_index, uint32_t)
+            {
+                size_t position = band_offset[chunk_index];
+                for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                {
+                    if (input_arr[iter] >= pivot_lower && input_arr[iter] <= pivot_upper)
+                    {
+                        band[position++] = input_arr[iter];
+                    }
+                }
+            });
 
-        return this->compute_MEDIAN(sorted_arr);
+        auto upper_mid = band.begin() + static_cast<std::ptrdiff_t>(rank_upper - total_below);
+        std::nth_element(band.begin(), upper_mid, band.end());
+        double result = *upper_mid;
+        if (rank_lower != rank_upper)
+        {
+            double lower_mid = *std::max_element(band.begin(), upper_mid);
+            result = (lower_mid + result) / 2.0;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Computes the median absolute deviation value of array by parallel selection without copying it.
+     *
+     * @param[in] thread_pool Threads used for the computation.
+     * @param[in] chunk_size The number of elements processed by a task.
+     * @param[in,out] scratch_arr A collection of number elements, it is overwritten with absolute deviations.
+     * @return double
+     */
+    double compute_MAD_parallel(THREAD_POOL &thread_pool, const size_t chunk_size, std::vector<double> &scratch_arr)
+    {
+        double median_val = this->compute_MEDIAN_parallel(thread_pool, chunk_size, scratch_arr);
+
+        thread_pool.parallel_for_chunks(
+            scratch_arr.size(), chunk_size,
+            [&](size_t chunk_begin, size_t chunk_end, size_t, uint32_t)
+            {
+                for (size_t iter = chunk_begin; iter < chunk_end; iter++)
+                {
+                    scratch_arr[iter] = std::abs(scratch_arr[iter] - median_val);
+                }
+            });
+
+        return this->compute_MEDIAN_parallel(thread_pool, chunk_size, scratch_arr);
     }
 
     /**
@@ -180,7 +416,7 @@ public:
      * @param[in] observed_y A collection of observed data's Y-Coordinate.
      * @param[out] residual A collection of raw residual.
      */
-    void compute_residual(double m_slope, double b_intercept, std::vector<double> &observed_x, std::vector<double> &observed_y, std::vector<double> &residual)
+    void compute_residual(double m_slope, double b_intercept, std::span<const double> observed_x, std::span<const double> observed_y, std::span<double> residual)
     {
         std::vector<double> predicted_val(observed_x.size(), 0); // can be replaced with manual memory allocation for performance
         for (uint32_t i = 0; i < observed_x.size(); i++)
@@ -203,7 +439,7 @@ public:
      * @param[in] y_predicted A collection of predicted data.
      * @param[out] residual A collection of raw residual.
      */
-    void compute_residual(const std::vector<double> &y_observed, const std::vector<double> &y_predicted, std::vector<double> &residual)
+    void compute_residual(std::span<const double> y_observed, std::span<const double> y_predicted, std::span<double> residual)
     {
         for (uint32_t i = 0; i < y_predicted.size(); i++)
         {
@@ -217,7 +453,7 @@ public:
      * @param[in] r_residual A collection of residual data
      * @return double
      */
-    double residual_sum_of_squared(std::vector<double> &r_residual)
+    double residual_sum_of_squared(std::span<const double> r_residual)
     {
         return compute_xx_sum(r_residual);
     }
@@ -229,7 +465,7 @@ public:
      * @param[in] y_predicted A collection of predicted data.
      * @return double
      */
-    double residual_sum_of_squared(std::vector<double> &y_observed, std::vector<double> &y_predicted)
+    double residual_sum_of_squared(std::span<const double> y_observed, std::span<const double> y_predicted)
     {
         double result = 0;
         for (uint32_t iter = 0; iter < y_observed.size(); iter++)
@@ -246,7 +482,7 @@ public:
      * @param[in] y_predicted A collection of predicted data.
      * @return double
      */
-    double residual_sum_L1_norm(std::vector<double> &y_observed, std::vector<double> &y_predicted)
+    double residual_sum_L1_norm(std::span<const double> y_observed, std::span<const double> y_predicted)
     {
         double result = 0;
         for (uint32_t iter = 0; iter < y_observed.size(); iter++)
@@ -255,4 +491,69 @@ public:
         }
         return result;
     }
+
+    /**
+     * @brief Initializes weight of observed data.
+     *
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
+     * @param[in] y_predicted A collection of predicted dependent variables (Y-Axis).
+     * @param[out] w_weight A collection of initialized weights.
+     */
+    void init_weight(
+        std::span<const double> y_observed,
+        std::span<const double> y_predicted,
+        std::span<double> w_weight)
+    {
+        for (uint32_t iter = 0; iter < w_weight.size(); iter++)
+        {
+            w_weight[iter] = 1.0 / std::pow((y_observed[iter] - y_predicted[iter]), 2);
+        }
+    }
+
+    /**
+     * @brief Computes leverage of observed data.
+     * @details
+     * The leverage is 1 / n + pow(x - x_mean, 2) / Sxx, where Sxx is the sum of pow(x - x_mean, 2).
+     * Sxx is accumulated from the centered values rather than derived from the sum of pow(x, 2),
+     * which loses the digits of Sxx when the data is far from the origin.
+     *
+     * @param[in] x_mean A average of observed data's independent variables (X-Axis).
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[out] h_leverage A collection of observed data's leverage
+     */
+    void compute_leverage(
+        const double x_mean,
+        std::span<const double> x_observed,
+        std::span<double> h_leverage)
+    {
+        double centered_xx_sum = 0.0;
+        for (uint32_t iter = 0; iter < h_leverage.size(); iter++)
+        {
+            h_leverage[iter] = std::pow((x_observed[iter] - x_mean), 2);
+            centered_xx_sum += h_leverage[iter];
+        }
+        const double inverse_num_points = 1.0 / static_cast<double>(x_observed.size());
+        for (uint32_t iter = 0; iter < h_leverage.size(); iter++)
+        {
+            h_leverage[iter] = inverse_num_points + (h_leverage[iter] / centered_xx_sum);
+        }
+    }
+
+protected:
+    /**
+     * @brief
+     * Gets the scratch buffer used by compute_MAD().
+     * A derived class may fill the buffer while it streams over the residuals
+     * and pass it to compute_MAD_in_place() to avoid a separate copy.
+     *
+     * @return std::vector<double>&
+     */
+    std::vector<double> &get_selection_buffer()
+    {
+        return this->m_selection_buffer;
+    }
+
+private:
+    std::vector<double> m_selection_buffer; // scratch buffer reused by compute_MAD() between iterations
+    std::vector<double> m_band_buffer;      // samples and candidates of compute_MEDIAN_parallel()
 };
\ No newline at end of file
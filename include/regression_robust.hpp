@@ -1,5 +1,19 @@
 #pragma once
 #include "regression_basic.hpp"
+#include "data_set.hpp"
+#include "simd_math.hpp"
+
+/**
+ * @brief
+ * ENUM CLASS that contains variables to choose the IRLS iteration engine of robust regression.
+ * STANDARD - Computes every intermediate result with a separate pass over the data.
+ * FUSED - Computes the weighted sums, predictions, residuals and stopping criterion with fused streaming passes.
+ */
+enum class IRLS_ENGINE
+{
+    STANDARD,
+    FUSED
+};
 
 /**
  * @brief
@@ -22,7 +36,22 @@ public:
      * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
      */
     REGRESSION_ROBUST(const std::vector<double> &x_observed, const std::vector<double> &y_observed)
-        : m_x_observed(x_observed), m_y_observed(y_observed), m_num_data_points(static_cast<uint32_t>(x_observed.size()))
+        : REGRESSION_ROBUST(DATA_SET(x_observed, y_observed))
+    {
+    }
+
+    /**
+     * @brief
+     * Construct a new REGRESSION_ROBUST object that shares the observed data with the given DATA_SET object
+     * without copying it, and initializes size vectors that will be used during computation.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     */
+    REGRESSION_ROBUST(const DATA_SET &observed_data)
+        : m_observed_data(observed_data),
+          m_x_observed(observed_data.get_x()),
+          m_y_observed(observed_data.get_y()),
+          m_num_data_points(static_cast<uint32_t>(observed_data.size()))
     {
         this->m_y_predicted = std::vector<double>(this->m_num_data_points, 0);
         this->m_r_residual = std::vector<double>(this->m_num_data_points, 0);
@@ -31,6 +60,7 @@ public:
         this->m_slope = 0;
         this->m_intercept = 0;
         this->m_num_iteration = 0;
+        this->m_engine = IRLS_ENGINE::FUSED;
     }
 
     virtual ~REGRESSION_ROBUST() {}
@@ -65,6 +95,18 @@ public:
         weight_retrived = this->m_w_weight;
     }
 
+    /**
+     * @brief
+     * Moves the weight of observed data point out of the object without copying it.
+     * The object does not hold the weight after the call.
+     *
+     * @return std::vector<double>
+     */
+    std::vector<double> release_weight()
+    {
+        return std::move(this->m_w_weight);
+    }
+
     /**
      * @brief Gets the number of iteration to complete the robust regression computation.
      *
@@ -76,26 +118,79 @@ public:
     }
 
     /**
-     * @brief Proceed regression with the given data.
+     * @brief Sets the IRLS iteration engine used by perform_regression().
+     *
+     * @param[in] target_engine Engine listed in IRLS_ENGINE.
+     */
+    void set_engine(const IRLS_ENGINE target_engine)
+    {
+        this->m_engine = target_engine;
+    }
+
+    /**
+     * @brief Gets the IRLS iteration engine used by perform_regression().
+     *
+     * @return IRLS_ENGINE
+     */
+    IRLS_ENGINE get_engine() const
+    {
+        return this->m_engine;
+    }
+
+    /**
+     * @brief Proceed regression with the given data by using the chosen IRLS engine.
+     * @details
+     * The sums of the initial OLS fit, the means and the sum of squares for the leverage are taken from
+     * the statistics stored with the data, e.g. in .dbin file, instead of scanning the data when they are known.
      *
      */
     void perform_regression()
+    {
+        switch (this->m_engine)
+        {
+        case IRLS_ENGINE::STANDARD:
+            this->perform_regression_standard();
+            break;
+
+        case IRLS_ENGINE::FUSED:
+            this->perform_regression_fused();
+            break;
+        }
+    }
+
+    /**
+     * @brief Proceed regression with the given data, each intermediate result is computed with a separate pass.
+     *
+     */
+    void perform_regression_standard()
     {
         double init_slope = 0;
         double init_intercept = 0;
-        REGRESSION_BASIC::ols_regression(m_x_observed, m_y_observed, m_slope, m_intercept);
+        const BLOCK_STATS *block_stats = m_observed_data.get_stats();
+        double x_mean = 0;
+        if (block_stats != nullptr)
+        {
+            REGRESSION_BASIC::ols_regression(block_stats->total, m_slope, m_intercept);
+            x_mean = block_stats->total.x_sum / static_cast<double>(m_num_data_points);
+        }
+        else
+        {
+            REGRESSION_BASIC::ols_regression(m_x_observed, m_y_observed, m_slope, m_intercept);
+            x_mean = REGRESSION_BASIC::compute_MEAN(m_x_observed);
+        }
         REGRESSION_BASIC::compute_predict(init_slope, init_intercept, m_x_observed, m_y_predicted);
         this->init_weight(m_y_observed, m_y_predicted, m_w_weight);
-
-        double x_mean = REGRESSION_BASIC::compute_MEAN(m_x_observed);
-        double xx_sum = REGRESSION_BASIC::compute_xx_sum(m_x_observed);
-        this->compute_leverage(x_mean, xx_sum, m_x_observed, m_h_leverage);
+        this->compute_leverage(x_mean, m_x_observed, m_h_leverage);
+        double y_mean = (block_stats != nullptr)
+                            ? block_stats->total.y_sum / static_cast<double>(m_num_data_points)
+                            : REGRESSION_BASIC::compute_MEAN(m_y_observed);
 
         double temp_m_slope = 0;
         double temp_b_intercept = 0;
         uint32_t num_iteration = 0;
         double residual_sum = REGRESSION_BASIC::residual_sum_of_squared(m_y_observed, m_y_predicted);
-        while (residual_sum > residual_tolerance && num_iteration < iteration_limit)
+        double residual_scale = residual_sum;
+        while (residual_sum > residual_tolerance * residual_scale && num_iteration < iteration_limit)
         {
             double weight_sum = REGRESSION_BASIC::compute_arr_sum(m_w_weight);
             double x_weight = REGRESSION_BASIC::compute_xy_sum(m_w_weight, m_x_observed) / weight_sum;
@@ -118,6 +213,75 @@ public:
             compute_weight(m_r_residual, m_h_leverage, val_MAD, m_w_weight);
 
             residual_sum = std::abs(REGRESSION_BASIC::compute_xy_sum(m_r_residual, m_w_weight));
+            residual_scale = 0;
+            for (uint32_t iter = 0; iter < m_num_data_points; iter++)
+            {
+                residual_scale += m_w_weight[iter] * std::abs(m_y_observed[iter] - y_mean);
+            }
+            num_iteration++;
+        }
+
+        this->m_slope = temp_m_slope;
+        this->m_intercept = temp_b_intercept;
+        this->m_num_iteration = num_iteration;
+    }
+
+    /**
+     * @brief Proceed regression with the given data, intermediate results are computed with fused passes.
+     * @details
+     * Each iteration streams over the data three times instead of nine.
+     * - Residual pass computes predictions and residuals, and fills the MAD selection buffer.
+     * - Weight pass computes weights with the M-estimator.
+     * - Accumulation pass computes the stopping criterion and the weighted sums for the next iteration.
+     * The weighted sums are accumulated around the means of the observed data
+     * to avoid cancellation when the single-pass formulas are used on data far from the origin.
+     *
+     */
+    void perform_regression_fused()
+    {
+        double init_slope = 0;
+        double init_intercept = 0;
+        const BLOCK_STATS *block_stats = m_observed_data.get_stats();
+        double x_mean = 0;
+        if (block_stats != nullptr)
+        {
+            REGRESSION_BASIC::ols_regression(block_stats->total, m_slope, m_intercept);
+            x_mean = block_stats->total.x_sum / static_cast<double>(m_num_data_points);
+        }
+        else
+        {
+            REGRESSION_BASIC::ols_regression(m_x_observed, m_y_observed, m_slope, m_intercept);
+            x_mean = REGRESSION_BASIC::compute_MEAN(m_x_observed);
+        }
+        REGRESSION_BASIC::compute_predict(init_slope, init_intercept, m_x_observed, m_y_predicted);
+        this->init_weight(m_y_observed, m_y_predicted, m_w_weight);
+        this->compute_leverage(x_mean, m_x_observed, m_h_leverage);
+
+        double x_shift = x_mean;
+        double y_shift = (block_stats != nullptr)
+                             ? block_stats->total.y_sum / static_cast<double>(m_num_data_points)
+                             : REGRESSION_BASIC::compute_MEAN(m_y_observed);
+
+        WEIGHTED_SUMS weighted_sums;
+        double residual_scale = 0;
+        this->accumulate_weighted_sums(x_shift, y_shift, weighted_sums, residual_scale);
+
+        double temp_m_slope = 0;
+        double temp_b_intercept = 0;
+        uint32_t num_iteration = 0;
+        double residual_sum = REGRESSION_BASIC::residual_sum_of_squared(m_y_observed, m_y_predicted);
+        residual_scale = residual_sum;
+        while (residual_sum > residual_tolerance * residual_scale && num_iteration < iteration_limit)
+        {
+            REGRESSION_BASIC::wls_from_sums(weighted_sums, x_shift, y_shift, temp_m_slope, temp_b_intercept);
+
+            this->compute_residual_fused(temp_m_slope, temp_b_intercept);
+
+            double val_MAD = REGRESSION_BASIC::compute_MAD_in_place(REGRESSION_BASIC::get_selection_buffer());
+
+            compute_weight(m_r_residual, m_h_leverage, val_MAD, m_w_weight);
+
+            residual_sum = std::abs(this->accumulate_weighted_sums(x_shift, y_shift, weighted_sums, residual_scale));
             num_iteration++;
         }
 
@@ -134,11 +298,13 @@ protected:
         std::vector<double> &weight) = 0;
 
 private:
-    const double residual_tolerance = 1E-08;
+    const double residual_tolerance = 1E-08; // relative to the sum of weight * abs(y - mean of y)
     const uint32_t iteration_limit = 1000;
+    IRLS_ENGINE m_engine;
 
-    std::vector<double> m_x_observed;
-    std::vector<double> m_y_observed;
+    DATA_SET m_observed_data; // keeps the observed data alive while the views below are used
+    std::span<const double> m_x_observed;
+    std::span<const double> m_y_observed;
     std::vector<double> m_y_predicted;
     std::vector<double> m_r_residual;
     std::vector<double> m_h_leverage;
@@ -150,40 +316,58 @@ private:
     double m_intercept;
 
     /**
-     * @brief Initializes weight of observed data.
+     * @brief
+     * Computes predicted data and raw residuals in a single pass, and
+     * copies the residuals into the MAD selection buffer at the same time.
      *
-     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
-     * @param[in] y_predicted A collection of predicted dependent variables (Y-Axis).
-     * @param[out] w_weight A collection of initialized weights.
+     * @param[in] m_slope An approximated slope of linear system.
+     * @param[in] b_intercept An approximated intercept of linear system.
      */
-    void init_weight(
-        const std::vector<double> &y_observed,
-        const std::vector<double> &y_predicted,
-        std::vector<double> &w_weight)
+    void compute_residual_fused(const double m_slope, const double b_intercept)
     {
-        for (uint32_t iter = 0; iter < w_weight.size(); iter++)
+        std::vector<double> &selection_buffer = REGRESSION_BASIC::get_selection_buffer();
+        selection_buffer.resize(m_num_data_points);
+        for (uint32_t iter = 0; iter < m_num_data_points; iter++)
         {
-            w_weight[iter] = 1.0 / std::pow((y_observed[iter] - y_predicted[iter]), 2);
+            double predicted = m_slope * m_x_observed[iter] + b_intercept;
+            double residual = m_y_observed[iter] - predicted;
+            m_y_predicted[iter] = predicted;
+            m_r_residual[iter] = residual;
+            selection_buffer[iter] = residual;
         }
     }
 
     /**
-     * @brief Computes leverage of observed data.
-     * 
-     * @param[in] x_mean A average of observed data's independent variables (X-Axis).
-     * @param[in] xx_sum A sum of pow(observed data's X-Axis, 2).
-     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
-     * @param[out] h_leverage A collection of observed data's leverage
+     * @brief
+     * Accumulates weighted sums of the shifted observed data and
+     * the inner product of residuals and weights in a single pass.
+     *
+     * @param[in] x_shift A value subtracted from observed data's independent variables (X-Axis).
+     * @param[in] y_shift A value subtracted from observed data's dependent variables (Y-Axis).
+     * @param[out] weighted_sums Weighted sums of the shifted observed data.
+     * @param[out] rw_abs_sum Sum of weight * abs(shifted Y-Axis), the scale of the stopping criterion.
+     * @return double Sum of residual * weight, used as stopping criterion.
      */
-    void compute_leverage(
-        const double x_mean,
-        const double xx_sum,
-        const std::vector<double> &x_observed,
-        std::vector<double> h_leverage)
+    double accumulate_weighted_sums(const double x_shift, const double y_shift, WEIGHTED_SUMS &weighted_sums, double &rw_abs_sum)
     {
-        for (uint32_t iter = 0; iter < h_leverage.size(); iter++)
+        WEIGHTED_SUMS temp_sums;
+        double rw_sum = 0.0;
+        double abs_sum = 0.0;
+        for (uint32_t iter = 0; iter < m_num_data_points; iter++)
         {
-            h_leverage[iter] = 1.0 / static_cast<double>(x_observed.size()) + (std::pow((x_observed[iter] - x_mean), 2) / xx_sum);
+            double w = m_w_weight[iter];
+            double dx = m_x_observed[iter] - x_shift;
+            double wdx = w * dx;
+            temp_sums.w_sum += w;
+            temp_sums.wx_sum += wdx;
+            temp_sums.wy_sum += w * (m_y_observed[iter] - y_shift);
+            temp_sums.wxx_sum += wdx * dx;
+            temp_sums.wxy_sum += wdx * (m_y_observed[iter] - y_shift);
+            rw_sum += m_r_residual[iter] * w;
+            abs_sum += w * std::abs(m_y_observed[iter] - y_shift);
         }
+        weighted_sums = temp_sums;
+        rw_abs_sum = abs_sum;
+        return rw_sum;
     }
 };
\ No newline at end of file
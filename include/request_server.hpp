@@ -0,0 +1,383 @@
+/**
+ * The file contains the long-running server mode of the program.
+ *
+ */
+#pragma once
+#include "facade_batch.hpp"
+#include "facade_plot.hpp"
+#include "data_io.hpp"
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @class REQUEST_SERVER
+ * @brief
+ * REQUEST_SERVER class reads fit requests from an input stream and writes the results to an output stream
+ * until the input ends or "quit" is received.
+ *
+ * @details
+ * A request is a line of words separated by spaces; a response is a line starting with "ok" or "error".
+ * - fit <weight_func> <detect_func> <num_points> [outliers]
+ *   followed by num_points lines of "x y" (or "x,y").
+ *   Responds "ok <slope> <intercept> <iterations> <num_outliers> <num_points>";
+ *   with "outliers", the response is followed by num_outliers lines of "x y".
+ * - fit_file <weight_func> <detect_func> <path> [output_dir]
+ *   loads .dvec, .csv or .dbin file and responds as "fit".
+ *   Only if output_dir is given, outlier_data.dvec, inlier_data.dvec and result_plot.bmp are written into it.
+ * - quit
+ *   ends the server.
+ * A failed request is answered with "error <message>", and the server continues with the next request.
+ * The thread pool and the workspaces of the robust regression are kept between requests;
+ * therefore, a request does not pay for starting threads or allocating buffers of the size seen before.
+ * Numbers in the response are written with 17 significant digits, so they are read back without rounding.
+ * REQUEST_SERVER class uses FACADE_BATCH and FACADE_PLOT with has-a relation.
+ */
+class REQUEST_SERVER
+{
+public:
+    /**
+     * @brief Construct a new REQUEST_SERVER object and starts its thread pool.
+     *
+     * @param[in] num_threads The number of threads, zero means the number of hardware threads.
+     * @param[in] chunk_size The number of data points processed by a task, zero means the default size.
+     */
+    REQUEST_SERVER(const uint32_t num_threads = 0, const uint32_t chunk_size = 0)
+        : m_batch(REGRESSION_METHOD::BISQUARE, DETECTION_METHOD::STANDARDIZED_RESIDUAL)
+    {
+        this->m_batch.set_parallel(num_threads, chunk_size);
+    }
+
+    /**
+     * @brief The default destructor, no special action required.
+     *
+     */
+    ~REQUEST_SERVER() {}
+
+    /**
+     * @brief Sets the io method "fit_file" requests load files with, IO_MODE::MAPPED by default.
+     *
+     * @param[in] io_mode The io method, e.g. IO_MODE::SAFE to report the line and the column of a malformed file.
+     */
+    void set_io_mode(const IO_MODE io_mode)
+    {
+        this->m_io_mode = io_mode;
+    }
+
+    /**
+     * @brief Sets the columns of multi-column .csv files "fit_file" requests load as X-Axis and Y-Axis.
+     *
+     * @param[in] csv_columns The columns, selected by name or by index.
+     */
+    void set_csv_columns(const CSV_COLUMNS &csv_columns)
+    {
+        this->m_csv_columns = csv_columns;
+    }
+
+    /**
+     * @brief Serves the requests read from request_stream until the stream ends or "quit" is received.
+     *
+     * @param[in] request_stream The stream requests are read from, e.g. std::cin.
+     * @param[out] response_stream The stream responses are written to, e.g. std::cout; it is flushed after every response.
+     */
+    void serve(std::istream &request_stream, std::ostream &response_stream)
+    {
+        response_stream << std::scientific << std::setprecision(16);
+
+        std::string request_line;
+        while (std::getline(request_stream, request_line))
+        {
+            std::vector<std::string> words = split_words(request_line);
+            if (words.empty() == true)
+            {
+                continue;
+            }
+            if (words[0] == "quit")
+            {
+                break;
+            }
+
+            try
+            {
+                if (words[0] == "fit")
+                {
+                    this->proceed_fit(words, request_stream, response_stream);
+                }
+                else if (words[0] == "fit_file")
+                {
+                    this->proceed_fit_file(words, response_stream);
+                }
+                else
+                {
+                    std::string error_message =
+                        "SERVER ERROR - THERE IS NO SUCH REQUEST.\n"
+                        "given - " + words[0] + " - does not exist.\n";
+                    throw std::runtime_error(error_message);
+                }
+            }
+            catch (const std::exception &error)
+            {
+                response_stream << "error " << flatten_message(error.what()) << "\n";
+            }
+            response_stream << std::flush;
+        }
+    }
+
+private:
+    /**
+     * @brief The largest number of data points reserved from the count of "fit" request before the data lines are read.
+     *
+     */
+    static constexpr uint32_t max_reserved_points = uint32_t(1) << 20;
+
+    FACADE_BATCH m_batch;
+    IO_MODE m_io_mode = IO_MODE::MAPPED;
+    std::optional<CSV_COLUMNS> m_csv_columns;
+
+    /**
+     * @brief Reads inline data points of "fit" request and responds with the result.
+     * @details The data lines are consumed even if the request is rejected, so the next request is read correctly.
+     *
+     * @param[in] words Words of the request line.
+     * @param[in] request_stream The stream the data lines are read from.
+     * @param[out] response_stream The stream the response is written to.
+     */
+    void proceed_fit(const std::vector<std::string> &words, std::istream &request_stream, std::ostream &response_stream)
+    {
+        if (words.size() < 4)
+        {
+            validate_num_words(words, 4, 5);
+        }
+        uint32_t num_points = 0;
+        auto [end_ptr, error_code] = std::from_chars(words[3].data(), words[3].data() + words[3].size(), num_points);
+        if (error_code != std::errc() || end_ptr != words[3].data() + words[3].size() || num_points == 0)
+        {
+            std::string error_message =
+                "SERVER ERROR - INVALID NUMBER OF DATA POINTS.\n"
+                "given - " + words[3] + " - is not a positive integer.\n";
+            throw std::runtime_error(error_message);
+        }
+
+        // the vectors grow with the lines actually received, so a huge count does not allocate before the data arrives
+        std::vector<double> x_observed;
+        std::vector<double> y_observed;
+        x_observed.reserve(std::min(num_points, max_reserved_points));
+        y_observed.reserve(std::min(num_points, max_reserved_points));
+        std::string data_line;
+        std::string error_message;
+        for (uint32_t iter = 0; iter < num_points; iter++)
+        {
+            if (!std::getline(request_stream, data_line))
+            {
+                error_message = "SERVER ERROR - MISSING DATA POINTS.\n";
+                break;
+            }
+            if (error_message.empty() == false)
+            {
+                continue; // the rest of the data lines are consumed without being stored
+            }
+            double x_value = 0;
+            double y_value = 0;
+            if (parse_point(data_line, x_value, y_value) == false)
+            {
+                error_message =
+                    "SERVER ERROR - INVALID DATA POINT.\n"
+                    "given - " + data_line + " - is not a pair of numbers.\n";
+                continue;
+            }
+            x_observed.push_back(x_value);
+            y_observed.push_back(y_value);
+        }
+        if (error_message.empty() == false)
+        {
+            throw std::runtime_error(error_message);
+        }
+        validate_num_words(words, 4, 5);
+
+        bool print_outliers = (words.size() == 5);
+        if (print_outliers == true && words[4] != "outliers")
+        {
+            error_message =
+                "SERVER ERROR - THERE IS NO SUCH OPTION.\n"
+                "given - " + words[4] + " - does not exist.\n";
+            throw std::runtime_error(error_message);
+        }
+
+        BATCH_RESULT result = this->proceed_data(words, DATA_SET(std::move(x_observed), std::move(y_observed)));
+        write_result(result, num_points, response_stream);
+        if (print_outliers == true)
+        {
+            std::span<const double> x_outliers = result.outliers.get_x();
+            std::span<const double> y_outliers = result.outliers.get_y();
+            for (size_t iter = 0; iter < x_outliers.size(); iter++)
+            {
+                response_stream << x_outliers[iter] << " " << y_outliers[iter] << "\n";
+            }
+        }
+    }
+
+    /**
+     * @brief Loads the data file of "fit_file" request and responds with the result.
+     *
+     * @param[in] words Words of the request line.
+     * @param[out] response_stream The stream the response is written to.
+     */
+    void proceed_fit_file(const std::vector<std::string> &words, std::ostream &response_stream)
+    {
+        validate_num_words(words, 4, 5);
+        if (is_standard_stream(words[3]) == true)
+        {
+            std::string error_message =
+                "SERVER ERROR - INVALID DATA FILE.\n"
+                "The standard input carries the requests; send the data points with fit request instead.\n";
+            throw std::runtime_error(error_message);
+        }
+
+        DATA_IO data_io(this->m_io_mode);
+        if (this->m_csv_columns.has_value() == true)
+        {
+            data_io.set_csv_columns(this->m_csv_columns.value());
+        }
+        DATA_SET observed_data;
+        data_io.load_data(words[3], observed_data);
+
+        BATCH_RESULT result = this->proceed_data(words, observed_data);
+        if (words.size() == 5)
+        {
+            std::filesystem::path output_dir(words[4]);
+            std::filesystem::create_directories(output_dir);
+            data_io.write_vec((output_dir / "outlier_data.dvec").string(), result.outliers);
+            data_io.write_vec((output_dir / "inlier_data.dvec").string(), result.inliers);
+
+            FACADE_PLOT plot_result(observed_data, result.outliers, result.inliers, result.m_slope, result.b_intercept);
+            plot_result.draw_all();
+            plot_result.generate_plot((output_dir / "result_plot.bmp").string());
+        }
+        write_result(result, observed_data.size(), response_stream);
+    }
+
+    /**
+     * @brief Performs robust regression and outlier detection with the methods named in the request.
+     *
+     * @param[in] words Words of the request line, the second and third words are the methods.
+     * @param[in] observed_data A collection of observed data points.
+     * @return BATCH_RESULT
+     */
+    BATCH_RESULT proceed_data(const std::vector<std::string> &words, const DATA_SET &observed_data)
+    {
+        this->m_batch.set_method(validate_reg_method(words[1]), validate_det_method(words[2]));
+        std::vector<BATCH_RESULT> results = this->m_batch.proceed_batch({observed_data});
+        return std::move(results[0]);
+    }
+
+    /**
+     * @brief Writes "ok" response line of a result.
+     *
+     * @param[in] result The result of robust regression and outlier detection.
+     * @param[in] num_points The number of data points in the request.
+     * @param[out] response_stream The stream the response is written to.
+     */
+    static void write_result(const BATCH_RESULT &result, const size_t num_points, std::ostream &response_stream)
+    {
+        response_stream << "ok "
+                        << result.m_slope << " "
+                        << result.b_intercept << " "
+                        << result.num_iteration << " "
+                        << result.num_outlier << " "
+                        << num_points << "\n";
+    }
+
+    /**
+     * @brief Parses a data line of "x y" or "x,y".
+     *
+     * @param[in] data_line A line of a data point.
+     * @param[out] x_value The independent variable (X-Axis) of the data point.
+     * @param[out] y_value The dependent variable (Y-Axis) of the data point.
+     * @return true When the line is a pair of numbers.
+     * @return false Otherwise.
+     */
+    static bool parse_point(const std::string &data_line, double &x_value, double &y_value)
+    {
+        const char *read_ptr = data_line.data();
+        const char *line_end = data_line.data() + data_line.size();
+        auto skip_separator = [&read_ptr, line_end]()
+        {
+            while (read_ptr < line_end && (*read_ptr == ' ' || *read_ptr == '\t' || *read_ptr == ',' || *read_ptr == '\r'))
+            {
+                read_ptr++;
+            }
+        };
+
+        skip_separator();
+        auto x_result = std::from_chars(read_ptr, line_end, x_value);
+        if (x_result.ec != std::errc())
+        {
+            return false;
+        }
+        read_ptr = x_result.ptr;
+        skip_separator();
+        auto y_result = std::from_chars(read_ptr, line_end, y_value);
+        if (y_result.ec != std::errc())
+        {
+            return false;
+        }
+        read_ptr = y_result.ptr;
+        skip_separator();
+        return read_ptr == line_end;
+    }
+
+    /**
+     * @brief Splits a request line into words separated by spaces.
+     *
+     * @param[in] request_line A line of a request.
+     * @return std::vector<std::string>
+     */
+    static std::vector<std::string> split_words(const std::string &request_line)
+    {
+        std::vector<std::string> words;
+        std::istringstream line_stream(request_line);
+        std::string word;
+        while (line_stream >> word)
+        {
+            words.push_back(word);
+        }
+        return words;
+    }
+
+    /**
+     * @brief Replaces line breaks of an error message with spaces, so the response stays a single line.
+     *
+     * @param[in] message The error message.
+     * @return std::string
+     */
+    static std::string flatten_message(std::string message)
+    {
+        std::replace(message.begin(), message.end(), '\n', ' ');
+        while (message.empty() == false && message.back() == ' ')
+        {
+            message.pop_back();
+        }
+        return message;
+    }
+
+    /**
+     * @brief
+     * Validates the number of words in a request line.
+     * It throws a runtime exception if the number is out of [min_words, max_words].
+     *
+     * @param[in] words Words of the request line.
+     * @param[in] min_words The smallest number of words.
+     * @param[in] max_words The largest number of words.
+     */
+    static void validate_num_words(const std::vector<std::string> &words, const size_t min_words, const size_t max_words)
+    {
+        if (words.size() < min_words || words.size() > max_words)
+        {
+            std::string error_message =
+                "SERVER ERROR - INVALID NUMBER OF ARGUMENTS.\n"
+                "Request " + words[0] + " requires " + std::to_string(min_words - 1) + " to " +
+                std::to_string(max_words - 1) + " arguments.\n";
+            throw std::runtime_error(error_message);
+        }
+    }
+};
@@ -0,0 +1,366 @@
+#pragma once
+#include "regression_basic.hpp"
+#include "data_set.hpp"
+#include "thread_pool.hpp"
+#include "irls_setup.hpp"
+#include "simd_math.hpp"
+
+/**
+ * @brief
+ * ROBUST_FIT class template performs robust regression with M-estimator chosen at compile time.
+ *
+ * @details
+ * ROBUST_FIT class template computes the same result as REGRESSION_ROBUST with IRLS_ENGINE::FUSED, but
+ * it uses static members of ESTIMATOR instead of the virtual function compute_weight().
+ * - ESTIMATOR::default_tunning_constant
+ * - ESTIMATOR::compute_weight_kernel(), which inlines ESTIMATOR::weight_function()
+ * Any M_ESTIMATOR_* class can be used as ESTIMATOR, and its object is never constructed.
+ * The weight kernel is called directly; therefore, it keeps its vectorized version chosen by SIMD_DISPATCH
+ * while the IRLS loop has no virtual function call.
+ * ROBUST_FIT object does not need heap allocation of itself and can be constructed on the stack.
+ * The part of computation that does not depend on ESTIMATOR is kept in IRLS_SETUP,
+ * which can be shared by ROBUST_FIT objects of different M-estimators running on the same data.
+ *
+ * @tparam ESTIMATOR A class that provides default_tunning_constant and static compute_weight_kernel().
+ */
+template <typename ESTIMATOR>
+class ROBUST_FIT : public REGRESSION_BASIC
+{
+public:
+    /**
+     * @brief
+     * Construct a new ROBUST_FIT object and initializes member variables including
+     * size vectors that will be used during computation.
+     *
+     * @param[in] x_observed A collection of observed data's independent variables (X-Axis).
+     * @param[in] y_observed A collection of observed data's dependent variables (Y-Axis).
+     * @param[in] custom_tunning Tunning constant, by default predefined value of ESTIMATOR will be used.
+     */
+    ROBUST_FIT(
+        const std::vector<double> &x_observed,
+        const std::vector<double> &y_observed,
+        double custom_tunning = 0)
+        : ROBUST_FIT(DATA_SET(x_observed, y_observed), custom_tunning)
+    {
+    }
+
+    /**
+     * @brief
+     * Construct a new ROBUST_FIT object that shares the observed data with the given DATA_SET object
+     * without copying it, and initializes size vectors that will be used during computation.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     * @param[in] custom_tunning Tunning constant, by default predefined value of ESTIMATOR will be used.
+     */
+    ROBUST_FIT(const DATA_SET &observed_data, double custom_tunning = 0)
+        : m_observed_data(observed_data),
+          m_x_observed(observed_data.get_x()),
+          m_y_observed(observed_data.get_y()),
+          m_num_data_points(static_cast<uint32_t>(observed_data.size()))
+    {
+        this->m_r_residual = std::vector<double>(this->m_num_data_points, 0);
+        this->m_w_weight = std::vector<double>(this->m_num_data_points, 0);
+        this->m_slope = 0;
+        this->m_intercept = 0;
+        this->m_num_iteration = 0;
+        this->m_tunning_constant = (custom_tunning == 0) ? ESTIMATOR::default_tunning_constant : custom_tunning;
+    }
+
+    /**
+     * @brief
+     * Construct a new ROBUST_FIT object that uses the setup computed in advance
+     * instead of computing it in perform_regression().
+     *
+     * @param[in] irls_setup Setup of robust regression computed from the observed data.
+     * @param[in] custom_tunning Tunning constant, by default predefined value of ESTIMATOR will be used.
+     */
+    ROBUST_FIT(std::shared_ptr<const IRLS_SETUP> irls_setup, double custom_tunning = 0)
+        : ROBUST_FIT(irls_setup->get_observed(), custom_tunning)
+    {
+        this->m_setup = std::move(irls_setup);
+    }
+
+    ~ROBUST_FIT() {}
+
+    /**
+     * @brief
+     * Sets the new data for robust regression computation without copying it.
+     * @details
+     * The buffers of the object are resized to the new data and keep their capacity;
+     * therefore, an object can be reused as a workspace for many data sets without reallocation
+     * once it has run on the largest one. The setup of the previous data is discarded.
+     *
+     * @param[in] observed_data A collection of observed data points.
+     */
+    void set_observed(const DATA_SET &observed_data)
+    {
+        this->m_observed_data = observed_data;
+        this->m_x_observed = observed_data.get_x();
+        this->m_y_observed = observed_data.get_y();
+        this->m_num_data_points = static_cast<uint32_t>(observed_data.size());
+        this->m_r_residual.assign(this->m_num_data_points, 0);
+        this->m_w_weight.assign(this->m_num_data_points, 0);
+        this->m_setup = nullptr;
+        this->m_slope = 0;
+        this->m_intercept = 0;
+        this->m_num_iteration = 0;
+    }
+
+    /**
+     * @brief Gets the approximate slope of the line of best fit.
+     *
+     * @return double
+     */
+    double get_slope() const
+    {
+        return this->m_slope;
+    }
+
+    /**
+     * @brief Gets the approximate intercept of the line of best fit.
+     *
+     * @return double
+     */
+    double get_intercept() const
+    {
+        return this->m_intercept;
+    }
+
+    /**
+     * @brief Gets the weight of observed data point computed during the robust regression process.
+     *
+     * @param[out] weight_retrived A collection of observed data's weight.
+     */
+    void get_weight(std::vector<double> &weight_retrived)
+    {
+        weight_retrived = this->m_w_weight;
+    }
+
+    /**
+     * @brief
+     * Gets the read-only view of the weight of observed data point without copying it.
+     * The view is valid until the next regression, set_observed() or release_weight().
+     *
+     * @return std::span<const double>
+     */
+    std::span<const double> get_weight() const
+    {
+        return this->m_w_weight;
+    }
+
+    /**
+     * @brief
+     * Moves the weight of observed data point out of the object without copying it.
+     * The object does not hold the weight after the call.
+     *
+     * @return std::vector<double>
+     */
+    std::vector<double> release_weight()
+    {
+        return std::move(this->m_w_weight);
+    }
+
+    /**
+     * @brief Gets the number of iteration to complete the robust regression computation.
+     *
+     * @return uint32_t
+     */
+    uint32_t get_num_iteration() const
+    {
+        return this->m_num_iteration;
+    }
+
+    /**
+     * @brief
+     * Sets the thread pool used by perform_regression().
+     * @details
+     * The data is split into chunks of chunk_size data points, and each pass over the data
+     * (sums, residuals, weights, MAD selection) is run chunk by chunk on the thread pool.
+     * Partial sums of the chunks are combined in chunk order; therefore,
+     * the result does not depend on the number of threads.
+     * The thread pool must outlive the call of perform_regression().
+     *
+     * @param[in] thread_pool Threads used for the computation.
+     * @param[in] chunk_size The number of data points processed by a task, zero means default_chunk_size.
+     */
+    void set_parallel(THREAD_POOL &thread_pool, const uint32_t chunk_size = 0)
+    {
+        this->m_thread_pool = &thread_pool;
+        this->m_chunk_size = (chunk_size == 0) ? default_chunk_size : chunk_size;
+    }
+
+    /**
+     * @brief
+     * The number of data points processed by a task in parallel mode.
+     * Six arrays of 8192 doubles (384 KiB) are touched by a task, which fits in L2 cache of common processors.
+     *
+     */
+    static constexpr uint32_t default_chunk_size = 8192;
+
+    /**
+     * @brief Proceed regression with the given data.
+     * @details
+     * If the setup is not given at the construction, it is computed first with the same threads and chunk size.
+     *
+     */
+    void perform_regression()
+    {
+        if (m_setup == nullptr)
+        {
+            m_setup = std::make_shared<const IRLS_SETUP>(m_observed_data, m_thread_pool, m_chunk_size);
+        }
+        const double x_mean = m_setup->get_x_mean();
+        const double y_mean = m_setup->get_y_mean();
+        const std::span<const double> h_leverage = m_setup->get_leverage();
+
+        const size_t num_chunks = count_chunks(m_num_data_points, m_chunk_size);
+        std::vector<WEIGHTED_SUMS> partial_sums(num_chunks);
+        std::vector<double> partial_rw_sums(num_chunks, 0.0);
+        std::vector<double> partial_rw_scales(num_chunks, 0.0);
+        WEIGHTED_SUMS weighted_sums = m_setup->get_initial_sums();
+
+        double temp_m_slope = 0;
+        double temp_b_intercept = 0;
+        uint32_t num_iteration = 0;
+        double residual_sum = m_setup->get_yy_sum(); // the initial prediction is zero
+        double residual_scale = residual_sum;
+        std::vector<double> &selection_buffer = REGRESSION_BASIC::get_selection_buffer();
+        selection_buffer.resize(m_num_data_points);
+        while (residual_sum > residual_tolerance * residual_scale && num_iteration < iteration_limit)
+        {
+            REGRESSION_BASIC::wls_from_sums(weighted_sums, x_mean, y_mean, temp_m_slope, temp_b_intercept);
+
+            run_chunks(m_thread_pool, m_num_data_points, m_chunk_size,
+                       [&](size_t chunk_begin, size_t chunk_end, size_t)
+                       { this->compute_residual_fused(chunk_begin, chunk_end, temp_m_slope, temp_b_intercept); });
+
+            double val_MAD = (m_thread_pool != nullptr && num_chunks > 1)
+                                 ? REGRESSION_BASIC::compute_MAD_parallel(*m_thread_pool, m_chunk_size, selection_buffer)
+                                 : REGRESSION_BASIC::compute_MAD_in_place(selection_buffer);
+            double const_val = m_tunning_constant * val_MAD / 0.6745;
+
+            run_chunks(m_thread_pool, m_num_data_points, m_chunk_size,
+                       [&](size_t chunk_begin, size_t chunk_end, size_t chunk_index)
+                       { partial_rw_sums[chunk_index] = this->update_weight_fused(
+                             chunk_begin, chunk_end, h_leverage, const_val, x_mean, y_mean,
+                             partial_sums[chunk_index], partial_rw_scales[chunk_index]); });
+            weighted_sums = WEIGHTED_SUMS();
+            for (const auto &chunk_sums : partial_sums)
+            {
+                weighted_sums.merge(chunk_sums);
+            }
+            residual_sum = std::abs(std::accumulate(partial_rw_sums.cbegin(), partial_rw_sums.cend(), 0.0));
+            residual_scale = std::accumulate(partial_rw_scales.cbegin(), partial_rw_scales.cend(), 0.0);
+            num_iteration++;
+        }
+
+        if (num_iteration == 0)
+        {
+            for (uint32_t iter = 0; iter < m_num_data_points; iter++)
+            {
+                m_w_weight[iter] = 1.0 / (m_y_observed[iter] * m_y_observed[iter]);
+            }
+        }
+
+        this->m_slope = temp_m_slope;
+        this->m_intercept = temp_b_intercept;
+        this->m_num_iteration = num_iteration;
+    }
+
+private:
+    const double residual_tolerance = 1E-08; // relative to the sum of weight * abs(y - mean of y)
+    const uint32_t iteration_limit = 1000;
+
+    DATA_SET m_observed_data; // keeps the observed data alive while the views below are used
+    std::span<const double> m_x_observed;
+    std::span<const double> m_y_observed;
+    std::vector<double> m_r_residual;
+    std::vector<double> m_w_weight;
+    std::shared_ptr<const IRLS_SETUP> m_setup;
+
+    uint32_t m_num_data_points;
+    uint32_t m_num_iteration;
+    double m_slope;
+    double m_intercept;
+    double m_tunning_constant;
+
+    THREAD_POOL *m_thread_pool = nullptr;
+    uint32_t m_chunk_size = default_chunk_size;
+
+    /**
+     * @brief
+     * Computes raw residuals in the range [range_begin, range_end) in a single pass, and
+     * copies the residuals into the MAD selection buffer at the same time.
+     * Predicted data are not stored since only the residuals are used by the next passes.
+     *
+     * @param[in] range_begin The first data point of the range.
+     * @param[in] range_end One past the last data point of the range.
+     * @param[in] m_slope An approximated slope of linear system.
+     * @param[in] b_intercept An approximated intercept of linear system.
+     */
+    void compute_residual_fused(const size_t range_begin, const size_t range_end, const double m_slope, const double b_intercept)
+    {
+        std::vector<double> &selection_buffer = REGRESSION_BASIC::get_selection_buffer();
+        for (size_t iter = range_begin; iter < range_end; iter++)
+        {
+            double predicted = m_slope * m_x_observed[iter] + b_intercept;
+            double residual = m_y_observed[iter] - predicted;
+            m_r_residual[iter] = residual;
+            selection_buffer[iter] = residual;
+        }
+    }
+
+    /**
+     * @brief
+     * Computes weight of observed data in the range [range_begin, range_end) with the weight kernel of ESTIMATOR, and
+     * accumulates weighted sums for the next iteration and the stopping criterion in a single pass.
+     *
+     * @param[in] range_begin The first data point of the range.
+     * @param[in] range_end One past the last data point of the range.
+     * @param[in] h_leverage A collection of observed data's leverage.
+     * @param[in] const_val A product of tunning constant and estimated standard deviation of the error term.
+     * @param[in] x_shift A value subtracted from observed data's independent variables (X-Axis).
+     * @param[in] y_shift A value subtracted from observed data's dependent variables (Y-Axis).
+     * @param[out] weighted_sums Weighted sums of the shifted observed data in the range.
+     * @param[out] rw_abs_sum Sum of weight * abs(shifted Y-Axis) in the range, the scale of the stopping criterion.
+     * @return double Sum of residual * weight in the range, used as stopping criterion.
+     */
+    double update_weight_fused(
+        const size_t range_begin,
+        const size_t range_end,
+        const std::span<const double> h_leverage,
+        const double const_val,
+        const double x_shift,
+        const double y_shift,
+        WEIGHTED_SUMS &weighted_sums,
+        double &rw_abs_sum)
+    {
+        ESTIMATOR::compute_weight_kernel(
+            m_r_residual.data() + range_begin,
+            h_leverage.data() + range_begin,
+            const_val,
+            m_w_weight.data() + range_begin,
+            static_cast<uint32_t>(range_end - range_begin));
+
+        WEIGHTED_SUMS temp_sums;
+        double rw_sum = 0.0;
+        double abs_sum = 0.0;
+        for (size_t iter = range_begin; iter < range_end; iter++)
+        {
+            double w = m_w_weight[iter];
+            double dx = m_x_observed[iter] - x_shift;
+            double dy = m_y_observed[iter] - y_shift;
+            double wdx = w * dx;
+            temp_sums.w_sum += w;
+            temp_sums.wx_sum += wdx;
+            temp_sums.wy_sum += w * dy;
+            temp_sums.wxx_sum += wdx * dx;
+            temp_sums.wxy_sum += wdx * dy;
+            rw_sum += m_r_residual[iter] * w;
+            abs_sum += w * std::abs(dy);
+        }
+        weighted_sums = temp_sums;
+        rw_abs_sum = abs_sum;
+        return rw_sum;
+    }
+};
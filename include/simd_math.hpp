@@ -0,0 +1,132 @@
+/**
+ * The file contains branch-free approximations of the elementary functions used by weight functions of M-estimators.
+ * The functions are written to be auto-vectorized by the compiler when they are called in a loop.
+ */
+#pragma once
+#include "PCH.hpp"
+#include <bit>
+#include <cstdint>
+
+/**
+ * @brief
+ * SIMD_DISPATCH generates AVX-512, AVX2 and default (SSE2 on x86-64) versions of a function, and
+ * the version is selected at program startup based on CPUID.
+ * @details
+ * The dispatch relies on ifunc support of ELF targets (Linux with GCC or CLANG).
+ * For other targets (MSVC, MinGW-w64), it expands to nothing and the default version is compiled.
+ * Loops in the function are vectorized only if sqrt does not need to set errno and
+ * both sides of a blend can be evaluated without regard to floating-point exceptions;
+ * therefore, CMakeLists.txt compiles the project with -fno-math-errno and -fno-trapping-math.
+ */
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SIMD_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef SIMD_DISPATCH
+#define SIMD_DISPATCH
+#endif
+
+/**
+ * @brief
+ * Computes exp(x) for x <= 0.
+ * @details
+ * x is reduced to x = n * ln(2) + f, |f| <= ln(2) / 2, then exp(f) is computed by
+ * degree 13 Taylor polynomial and scaled by 2^n through the exponent bits.
+ * The relative error is below 3E-16 for -708 <= x <= 0.
+ * The function returns 0 for x < -708, where the absolute error is below 2.3E-308.
+ *
+ * @param[in] x A number not greater than zero.
+ * @return double
+ */
+inline double simd_exp_nonpositive(const double x)
+{
+    const double round_magic = 0x1.8p52; // adding it rounds a number to an integer held in the low mantissa bits
+    const double x_clamped = x < -708.0 ? -708.0 : x;
+
+    const double shifted = x_clamped * std::numbers::log2e + round_magic;
+    const double n = shifted - round_magic;
+    const double f = (x_clamped - n * 6.93147180369123816490E-01) - n * 1.90821492927058770002E-10;
+
+    double poly = 1.0 / 6227020800.0;
+    poly = poly * f + 1.0 / 479001600.0;
+    poly = poly * f + 1.0 / 39916800.0;
+    poly = poly * f + 1.0 / 3628800.0;
+    poly = poly * f + 1.0 / 362880.0;
+    poly = poly * f + 1.0 / 40320.0;
+    poly = poly * f + 1.0 / 5040.0;
+    poly = poly * f + 1.0 / 720.0;
+    poly = poly * f + 1.0 / 120.0;
+    poly = poly * f + 1.0 / 24.0;
+    poly = poly * f + 1.0 / 6.0;
+    poly = poly * f + 0.5;
+    poly = poly * f + 1.0;
+    poly = poly * f + 1.0;
+
+    const uint64_t exponent_bits = std::bit_cast<uint64_t>(shifted) - std::bit_cast<uint64_t>(round_magic) + 1023;
+    const double result = poly * std::bit_cast<double>(exponent_bits << 52);
+    return x < -708.0 ? 0.0 : result;
+}
+
+/**
+ * @brief
+ * Computes sin(x) / x for |x| <= pi.
+ * @details
+ * The function evaluates degree 28 Taylor polynomial of sin(x) / x in x^2,
+ * and the absolute error is below 4E-16 for |x| <= pi.
+ * The input is clamped to pi; therefore, the caller must mask the result when |x| > pi.
+ * Unlike std::sin(x) / x, it returns 1 at x = 0.
+ *
+ * @param[in] x A number
+ * @return double
+ */
+inline double simd_sin_over_x(const double x)
+{
+    const double x_abs = std::abs(x);
+    const double x_clamped = x_abs < std::numbers::pi ? x_abs : std::numbers::pi;
+    const double xx = x_clamped * x_clamped;
+
+    double poly = 1.0 / 8.8417619937397019545E+30; // 1 / 29!
+    poly = -poly * xx + 1.0 / 1.0888869450418352160E+28;
+    poly = -poly * xx + 1.0 / 1.5511210043330985984E+25;
+    poly = -poly * xx + 1.0 / 2.5852016738884976640E+22;
+    poly = -poly * xx + 1.0 / 5.1090942171709440000E+19;
+    poly = -poly * xx + 1.0 / 1.2164510040883200000E+17;
+    poly = -poly * xx + 1.0 / 355687428096000.0;
+    poly = -poly * xx + 1.0 / 1307674368000.0;
+    poly = -poly * xx + 1.0 / 6227020800.0;
+    poly = -poly * xx + 1.0 / 39916800.0;
+    poly = -poly * xx + 1.0 / 362880.0;
+    poly = -poly * xx + 1.0 / 5040.0;
+    poly = -poly * xx + 1.0 / 120.0;
+    poly = -poly * xx + 1.0 / 6.0;
+    poly = -poly * xx + 1.0;
+    return poly;
+}
+
+/**
+ * @brief
+ * Computes tanh(x) / x.
+ * @details
+ * tanh(|x|) is computed as (1 - exp(-2|x|)) / (1 + exp(-2|x|)) with simd_exp_nonpositive().
+ * For |x| < 1E-02, where the formula loses precision by cancellation,
+ * degree 6 Taylor polynomial is used instead.
+ * The relative error is below 1E-14.
+ * Unlike std::tanh(x) / x, it returns 1 at x = 0.
+ *
+ * @param[in] x A number
+ * @return double
+ */
+inline double simd_tanh_over_x(const double x)
+{
+    const double x_abs = std::abs(x);
+    const double x_clamped = x_abs < 20.0 ? x_abs : 20.0; // tanh(20) rounds to 1
+
+    const double exp_term = simd_exp_nonpositive(-2.0 * x_clamped);
+    const double by_formula = ((1.0 - exp_term) / (1.0 + exp_term)) / x_abs;
+
+    const double xx = x_abs * x_abs;
+    const double by_series = 1.0 + xx * (-1.0 / 3.0 + xx * (2.0 / 15.0 + xx * (-17.0 / 315.0)));
+
+    return x_abs < 1E-02 ? by_series : by_formula;
+}
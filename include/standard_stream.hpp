@@ -0,0 +1,46 @@
+/**
+ * The file contains the file name of the standard input and the standard output used by the data files.
+ */
+#pragma once
+#include "PCH.hpp"
+#include <cstdio>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+/**
+ * @brief
+ * The file name denoting the standard input when a data file is read and the standard output when it is written,
+ * as Unix tools do, so the program can be used in a pipeline without temporary files.
+ */
+inline constexpr const char *standard_stream_name = "-";
+
+/**
+ * @brief Checks whether the file name denotes the standard input or the standard output.
+ *
+ * @param[in] file_name The file name.
+ * @return true When the file name is standard_stream_name.
+ * @return false Otherwise.
+ */
+inline bool is_standard_stream(const std::string &file_name)
+{
+    return file_name == standard_stream_name;
+}
+
+/**
+ * @brief
+ * Switches the standard stream to binary mode so that .dbin data and line breaks are not translated.
+ * It does nothing except on Windows, where the standard streams are opened in text mode.
+ *
+ * @param[in] standard_stream stdin or stdout.
+ */
+inline void set_binary_mode(std::FILE *standard_stream)
+{
+#if defined(_WIN32)
+    _setmode(_fileno(standard_stream), _O_BINARY);
+#else
+    (void)standard_stream;
+#endif
+}
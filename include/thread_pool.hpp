@@ -0,0 +1,297 @@
+/**
+ * The file contains the thread pool shared by parallel computation of the project.
+ */
+#pragma once
+#include "PCH.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class THREAD_POOL
+ * @brief
+ * THREAD_POOL class is a fixed-size collection of worker threads that executes indexed tasks in parallel.
+ *
+ * @details
+ * THREAD_POOL class provides parallel_for() only.
+ * The calling thread takes part in the computation; therefore,
+ * a pool of N threads starts N - 1 worker threads, and a pool of 1 thread runs every task on the calling thread.
+ * Tasks are claimed one by one from a shared counter, so a thread that finished a short task takes the next one
+ * instead of waiting for a thread that got a long one.
+ * parallel_for() can be called from a task of another parallel_for();
+ * the inner call never waits for a worker thread that has not started, so nested calls cannot deadlock.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * @brief Constructs a new THREAD_POOL object and starts its worker threads.
+     *
+     * @param[in] num_threads The number of threads including the calling thread, zero means the number of hardware threads.
+     */
+    explicit THREAD_POOL(uint32_t num_threads = 0)
+    {
+        if (num_threads == 0)
+        {
+            num_threads = std::thread::hardware_concurrency();
+            num_threads = (num_threads == 0) ? 1 : num_threads;
+        }
+        this->m_num_threads = num_threads;
+
+        this->m_workers.reserve(num_threads - 1);
+        for (uint32_t iter = 1; iter < num_threads; iter++)
+        {
+            this->m_workers.emplace_back([this]()
+                                         { this->run_worker(); });
+        }
+    }
+
+    THREAD_POOL(const THREAD_POOL &) = delete;
+    THREAD_POOL &operator=(const THREAD_POOL &) = delete;
+
+    /**
+     * @brief Stops and joins the worker threads, queued tasks that have not started are abandoned.
+     *
+     */
+    ~THREAD_POOL()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->m_queue_mutex);
+            this->m_is_stopped = true;
+        }
+        this->m_queue_cv.notify_all();
+        for (auto &worker : this->m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Gets the number of threads including the calling thread.
+     *
+     * @return uint32_t
+     */
+    uint32_t get_num_threads() const
+    {
+        return this->m_num_threads;
+    }
+
+    /**
+     * @brief
+     * Runs task(task_index, thread_index) for every task_index in [0, num_tasks) and
+     * returns when all of them are completed.
+     * @details
+     * thread_index is smaller than get_num_threads() and unique among the threads running the same parallel_for(),
+     * so it can be used to choose a per-thread workspace.
+     * If a task throws an exception, the remaining tasks still run and the first exception is rethrown.
+     *
+     * @tparam FUNCTION A callable object with signature void(size_t, uint32_t).
+     * @param[in] num_tasks The number of tasks.
+     * @param[in] task The task to be run.
+     */
+    template <typename FUNCTION>
+    void parallel_for(const size_t num_tasks, FUNCTION &&task)
+    {
+        if (num_tasks == 0)
+        {
+            return;
+        }
+        if (this->m_workers.empty() == true || num_tasks == 1)
+        {
+            for (size_t iter = 0; iter < num_tasks; iter++)
+            {
+                task(iter, 0);
+            }
+            return;
+        }
+
+        auto job = std::make_shared<PARALLEL_JOB>();
+        job->task = std::forward<FUNCTION>(task);
+        job->num_tasks = num_tasks;
+
+        size_t num_helpers = std::min(this->m_workers.size(), num_tasks - 1);
+        {
+            std::lock_guard<std::mutex> lock(this->m_queue_mutex);
+            for (size_t iter = 0; iter < num_helpers; iter++)
+            {
+                this->m_queue.emplace_back([job]()
+                                           { run_job(*job, job->next_thread_index.fetch_add(1)); });
+            }
+        }
+        this->m_queue_cv.notify_all();
+
+        run_job(*job, 0);
+
+        std::unique_lock<std::mutex> lock(job->done_mutex);
+        job->done_cv.wait(lock, [&job]()
+                          { return job->num_completed.load() == job->num_tasks; });
+        if (job->error != nullptr)
+        {
+            std::rethrow_exception(job->error);
+        }
+    }
+
+    /**
+     * @brief
+     * Runs task(chunk_begin, chunk_end, chunk_index, thread_index) for every chunk of [0, num_elements),
+     * each chunk has chunk_size elements except the last one.
+     *
+     * @tparam FUNCTION A callable object with signature void(size_t, size_t, size_t, uint32_t).
+     * @param[in] num_elements The number of elements to be split into chunks.
+     * @param[in] chunk_size The number of elements in a chunk.
+     * @param[in] task The task to be run on each chunk.
+     */
+    template <typename FUNCTION>
+    void parallel_for_chunks(const size_t num_elements, const size_t chunk_size, FUNCTION &&task)
+    {
+        size_t num_chunks = get_num_chunks(num_elements, chunk_size);
+        this->parallel_for(num_chunks, [&task, num_elements, chunk_size](size_t chunk_index, uint32_t thread_index)
+                           {
+                               size_t chunk_begin = chunk_index * chunk_size;
+                               size_t chunk_end = std::min(chunk_begin + chunk_size, num_elements);
+                               task(chunk_begin, chunk_end, chunk_index, thread_index); });
+    }
+
+    /**
+     * @brief Gets the number of chunks parallel_for_chunks() splits the elements into.
+     *
+     * @param[in] num_elements The number of elements to be split into chunks.
+     * @param[in] chunk_size The number of elements in a chunk.
+     * @return size_t
+     */
+    static size_t get_num_chunks(const size_t num_elements, const size_t chunk_size)
+    {
+        return (num_elements + chunk_size - 1) / chunk_size;
+    }
+
+private:
+    /**
+     * @brief State of a parallel_for() call shared by the calling thread and the worker threads helping it.
+     *
+     */
+    struct PARALLEL_JOB
+    {
+        std::function<void(size_t, uint32_t)> task;
+        size_t num_tasks = 0;
+        std::atomic<size_t> next_task{0};
+        std::atomic<size_t> num_completed{0};
+        std::atomic<uint32_t> next_thread_index{1};
+        std::mutex done_mutex;
+        std::condition_variable done_cv;
+        std::exception_ptr error;
+    };
+
+    uint32_t m_num_threads;
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_queue;
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_cv;
+    bool m_is_stopped = false;
+
+    /**
+     * @brief Claims and runs tasks of the job until no task is left.
+     *
+     * @param[in,out] job The job to be run.
+     * @param[in] thread_index The index of the running thread within the job.
+     */
+    static void run_job(PARALLEL_JOB &job, const uint32_t thread_index)
+    {
+        size_t task_index = job.next_task.fetch_add(1);
+        while (task_index < job.num_tasks)
+        {
+            try
+            {
+                job.task(task_index, thread_index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job.done_mutex);
+                if (job.error == nullptr)
+                {
+                    job.error = std::current_exception();
+                }
+            }
+
+            if (job.num_completed.fetch_add(1) + 1 == job.num_tasks)
+            {
+                std::lock_guard<std::mutex> lock(job.done_mutex);
+                job.done_cv.notify_all();
+            }
+            task_index = job.next_task.fetch_add(1);
+        }
+    }
+
+    /**
+     * @brief Main loop of a worker thread, runs queued helpers until the pool is destroyed.
+     *
+     */
+    void run_worker()
+    {
+        while (true)
+        {
+            std::function<void()> helper;
+            {
+                std::unique_lock<std::mutex> lock(this->m_queue_mutex);
+                this->m_queue_cv.wait(lock, [this]()
+                                      { return this->m_is_stopped || this->m_queue.empty() == false; });
+                if (this->m_is_stopped == true)
+                {
+                    return;
+                }
+                helper = std::move(this->m_queue.front());
+                this->m_queue.pop_front();
+            }
+            helper();
+        }
+    }
+};
+
+/**
+ * @brief
+ * Gets the number of chunks run_chunks() splits the elements into, at least one.
+ * It does not depend on the thread pool, so partial sums of the chunks are combined in the same order
+ * and give the same result whatever the number of threads is.
+ *
+ * @param[in] num_elements The number of elements to be split into chunks.
+ * @param[in] chunk_size The number of elements in a chunk.
+ * @return size_t
+ */
+inline size_t count_chunks(const size_t num_elements, const size_t chunk_size)
+{
+    return std::max(THREAD_POOL::get_num_chunks(num_elements, chunk_size), size_t(1));
+}
+
+/**
+ * @brief
+ * Runs task(chunk_begin, chunk_end, chunk_index) for every chunk of [0, num_elements) on the thread pool.
+ * If thread_pool is null or has a single thread, the chunks run in order on the calling thread.
+ * An empty range is a single empty chunk.
+ *
+ * @tparam FUNCTION A callable object with signature void(size_t, size_t, size_t).
+ * @param[in] thread_pool Threads used for the computation, it can be null.
+ * @param[in] num_elements The number of elements to be split into chunks.
+ * @param[in] chunk_size The number of elements in a chunk.
+ * @param[in] task The task to be run on each chunk.
+ */
+template <typename FUNCTION>
+void run_chunks(THREAD_POOL *thread_pool, const size_t num_elements, const size_t chunk_size, FUNCTION &&task)
+{
+    const size_t num_chunks = count_chunks(num_elements, chunk_size);
+    if (thread_pool == nullptr || thread_pool->get_num_threads() == 1 || num_chunks == 1)
+    {
+        for (size_t chunk_index = 0; chunk_index < num_chunks; chunk_index++)
+        {
+            size_t chunk_begin = std::min(chunk_index * chunk_size, num_elements);
+            task(chunk_begin, std::min(chunk_begin + chunk_size, num_elements), chunk_index);
+        }
+        return;
+    }
+    thread_pool->parallel_for_chunks(
+        num_elements, chunk_size,
+        [&task](size_t chunk_begin, size_t chunk_end, size_t chunk_index, uint32_t)
+        { task(chunk_begin, chunk_end, chunk_index); });
+}
@@ -2,10 +2,715 @@
 #include "include/facade_detection.hpp"
 #include "include/facade_plot.hpp"
 #include "include/data_io.hpp"
+#include "include/data_archive.hpp"
+#include "include/request_server.hpp"
+#include "include/facade_batch.hpp"
+#include <charconv>
+#include <chrono>
+#include <iomanip>
+
+/**
+ * @brief Options given after the three positional command-line arguments.
+ *
+ */
+struct RUN_OPTION
+{
+    uint32_t num_threads = 1; // 0 - number of hardware threads
+    uint32_t chunk_size = 0;  // 0 - default chunk size
+    uint32_t write_plot = 1;  // 0 - result_plot.bmp is not written
+    uint32_t safe_load = 0;   // 1 - input files are validated with IO_MODE::SAFE
+    std::string compress_suffix; // ".gz" or ".zst" - output data files are compressed
+    std::optional<CSV_COLUMNS> csv_columns; // columns of multi-column .csv input files loaded as X and Y
+    std::string stream_format = ".dvec";    // format of the standard input ("-") and the standard output
+    std::string stdout_data;                // "outliers" or "inliers" - written to the standard output instead of the files
+    std::optional<std::pair<double, double>> x_range; // only the data points with x in [first, second] are fitted
+};
+
+/**
+ * @brief Chooses the io method of loading input files based on the options.
+ *
+ * @param[in] run_option Options given through command-line arguments.
+ * @param[in] is_parallel Whether a thread pool is available for loading.
+ * @return IO_MODE
+ */
+IO_MODE get_load_mode(const RUN_OPTION &run_option, const bool is_parallel)
+{
+    if (run_option.safe_load != 0)
+    {
+        return IO_MODE::SAFE;
+    }
+    return (is_parallel == true) ? IO_MODE::PARALLEL : IO_MODE::MAPPED;
+}
+
+/**
+ * @brief Creates DATA_IO object that loads input files with the io method and the .csv columns chosen by the options.
+ *
+ * @param[in] run_option Options given through command-line arguments.
+ * @param[in] is_parallel Whether a thread pool is available for loading.
+ * @return DATA_IO
+ */
+DATA_IO make_input_io(const RUN_OPTION &run_option, const bool is_parallel)
+{
+    DATA_IO data_io(get_load_mode(run_option, is_parallel));
+    data_io.set_stream_format(run_option.stream_format);
+    if (run_option.csv_columns.has_value() == true)
+    {
+        data_io.set_csv_columns(run_option.csv_columns.value());
+    }
+    return data_io;
+}
+
+/**
+ * @brief
+ * Converts a value of command-line option into a non-negative integer.
+ * It throws a runtime exception if the value is not a non-negative integer.
+ *
+ * @param[in] option_name Name of the option.
+ * @param[in] option_value Value of the option.
+ * @return uint32_t
+ */
+uint32_t validate_option_number(const std::string &option_name, const std::string &option_value)
+{
+    uint32_t result = 0;
+    auto [end_ptr, error_code] = std::from_chars(option_value.data(), option_value.data() + option_value.size(), result);
+    if (error_code != std::errc() || end_ptr != option_value.data() + option_value.size())
+    {
+        std::string error_message =
+            "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+            "Option " + option_name + " requires a non-negative integer, but\n"
+            "given - " + option_value + " - is not.\n";
+        throw std::runtime_error(error_message);
+    }
+    return result;
+}
+
+/**
+ * @brief
+ * Reads options from the command-line arguments starting at first_option.
+ * It throws a runtime exception if an option does not exist or its value is missing.
+ *
+ * @param[in] argc The number of command-line arguments.
+ * @param[in] argv The command-line arguments.
+ * @param[in] first_option Index of the first option in argv.
+ * @param[in] run_option Values of options that are not given.
+ * @return RUN_OPTION
+ */
+RUN_OPTION validate_run_option(int argc, char *argv[], int first_option, RUN_OPTION run_option = RUN_OPTION())
+{
+    for (int iter = first_option; iter < argc; iter += 2)
+    {
+        std::string option_name = argv[iter];
+        if (iter + 1 >= argc)
+        {
+            std::string error_message =
+                "INPUT ARGUMENT ERROR - MISSING OPTION VALUE.\n"
+                "Option " + option_name + " requires a value.\n";
+            throw std::runtime_error(error_message);
+        }
+        std::string option_value = argv[iter + 1];
+
+        if (option_name == "--threads")
+        {
+            run_option.num_threads = validate_option_number(option_name, option_value);
+        }
+        else if (option_name == "--chunk")
+        {
+            run_option.chunk_size = validate_option_number(option_name, option_value);
+        }
+        else if (option_name == "--plot")
+        {
+            run_option.write_plot = validate_option_number(option_name, option_value);
+        }
+        else if (option_name == "--safe")
+        {
+            run_option.safe_load = validate_option_number(option_name, option_value);
+        }
+        else if (option_name == "--compress")
+        {
+            if (option_value != "none" && option_value != "gz" && option_value != "zst")
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "Option " + option_name + " requires none, gz or zst, but\n"
+                    "given - " + option_value + " - is not.\n";
+                throw std::runtime_error(error_message);
+            }
+            run_option.compress_suffix = (option_value == "none") ? "" : "." + option_value;
+            if (is_compression_supported(get_compression("output" + run_option.compress_suffix)) == false)
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "The program is built without the library of " + option_value + " compression.\n";
+                throw std::runtime_error(error_message);
+            }
+        }
+        else if (option_name == "--format")
+        {
+            if (option_value != "dvec" && option_value != "csv" && option_value != "dbin")
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "Option " + option_name + " requires dvec, csv or dbin, but\n"
+                    "given - " + option_value + " - is not.\n";
+                throw std::runtime_error(error_message);
+            }
+            run_option.stream_format = "." + option_value;
+        }
+        else if (option_name == "--stdout")
+        {
+            if (option_value != "none" && option_value != "outliers" && option_value != "inliers")
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "Option " + option_name + " requires none, outliers or inliers, but\n"
+                    "given - " + option_value + " - is not.\n";
+                throw std::runtime_error(error_message);
+            }
+            run_option.stdout_data = (option_value == "none") ? "" : option_value;
+        }
+        else if (option_name == "--columns")
+        {
+            size_t comma_pos = option_value.find(',');
+            if (comma_pos == std::string::npos || comma_pos == 0 || comma_pos + 1 == option_value.size() ||
+                option_value.find(',', comma_pos + 1) != std::string::npos)
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "Option " + option_name + " requires the X and Y columns separated by a comma, e.g. time,price or 0,3, but\n"
+                    "given - " + option_value + " - is not.\n";
+                throw std::runtime_error(error_message);
+            }
+            CSV_COLUMNS csv_columns;
+            csv_columns.x_column = to_csv_column(option_value.substr(0, comma_pos));
+            csv_columns.y_column = to_csv_column(option_value.substr(comma_pos + 1));
+            run_option.csv_columns = csv_columns;
+        }
+        else if (option_name == "--x-range")
+        {
+            size_t comma_pos = option_value.find(',');
+            double x_low = 0;
+            double x_high = 0;
+            const char *value_end = option_value.data() + option_value.size();
+            bool is_valid = comma_pos != std::string::npos &&
+                            std::from_chars(option_value.data(), option_value.data() + comma_pos, x_low).ptr == option_value.data() + comma_pos &&
+                            std::from_chars(option_value.data() + comma_pos + 1, value_end, x_high).ptr == value_end &&
+                            comma_pos != 0 && comma_pos + 1 != option_value.size() && x_low <= x_high;
+            if (is_valid == false)
+            {
+                std::string error_message =
+                    "INPUT ARGUMENT ERROR - INVALID OPTION VALUE.\n"
+                    "Option " + option_name + " requires the lowest and the highest X separated by a comma, e.g. 100,200, but\n"
+                    "given - " + option_value + " - is not.\n";
+                throw std::runtime_error(error_message);
+            }
+            run_option.x_range = std::make_pair(x_low, x_high);
+        }
+        else
+        {
+            std::string error_message =
+                "INPUT ARGUMENT ERROR - THERE IS NO SUCH OPTION.\n"
+                "given - " + option_name + " - does not exist.\n"
+                "Please choose the correct option based on the instruction by executing the program without parameters.";
+            throw std::runtime_error(error_message);
+        }
+    }
+    return run_option;
+}
+
+/**
+ * @brief
+ * Runs robust regression with every given weight function on the same data and
+ * prints slope, intercept, the number of iterations and wall time of each weight function.
+ *
+ * @param[in] method_list Comma-separated list of weight functions or "all".
+ * @param[in] file_name Path to the observed data file.
+ * @param[in] run_option Options given through command-line arguments.
+ */
+void run_comparison(const std::string &method_list, const std::string &file_name, const RUN_OPTION &run_option)
+{
+    std::vector<REGRESSION_METHOD> reg_methods = validate_reg_method_list(method_list);
+
+    std::shared_ptr<THREAD_POOL> thread_pool = (run_option.num_threads != 1) ? std::make_shared<THREAD_POOL>(run_option.num_threads) : nullptr;
+    DATA_IO data_io = make_input_io(run_option, thread_pool != nullptr);
+    data_io.set_parallel(thread_pool);
+    DATA_SET observed_data;
+    data_io.load_data(file_name, observed_data);
+
+    FACADE_REGRESSION regression;
+    regression.set_observed(observed_data);
+    if (run_option.x_range.has_value() == true)
+    {
+        regression.set_x_range(run_option.x_range->first, run_option.x_range->second);
+        observed_data = regression.get_observed();
+    }
+    if (thread_pool != nullptr)
+    {
+        regression.set_parallel(thread_pool, run_option.chunk_size);
+    }
+
+    auto time_start = std::chrono::steady_clock::now();
+    std::vector<REGRESSION_RESULT> results = regression.proceed_comparison(reg_methods);
+    double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+    std::cout << std::left << std::setw(12) << "method"
+              << std::setw(16) << "slope"
+              << std::setw(16) << "intercept"
+              << std::setw(12) << "iterations"
+              << "time [ms]" << "\n";
+    for (const auto &result : results)
+    {
+        std::cout << std::left << std::setw(12) << get_reg_method_name(result.method)
+                  << std::scientific << std::setprecision(6)
+                  << std::setw(16) << result.m_slope
+                  << std::setw(16) << result.b_intercept
+                  << std::setw(12) << result.num_iteration
+                  << std::fixed << std::setprecision(3) << result.wall_time * 1000.0 << "\n";
+    }
+    std::cout << "Compared " << results.size() << " methods on " << observed_data.size() << " data points in "
+              << std::fixed << std::setprecision(3) << total_time * 1000.0 << " ms\n"
+              << std::endl;
+}
+
+/**
+ * @brief Checks a file name matches a pattern where '*' matches any characters and '?' matches a character.
+ *
+ * @param[in] pattern The pattern of file name.
+ * @param[in] file_name The file name to be checked.
+ * @return true When the file name matches the pattern.
+ * @return false Otherwise.
+ */
+bool match_wildcard(const std::string &pattern, const std::string &file_name)
+{
+    size_t pattern_pos = 0;
+    size_t name_pos = 0;
+    size_t star_pos = std::string::npos;
+    size_t star_name_pos = 0;
+    while (name_pos < file_name.size())
+    {
+        if (pattern_pos < pattern.size() && (pattern[pattern_pos] == '?' || pattern[pattern_pos] == file_name[name_pos]))
+        {
+            pattern_pos++;
+            name_pos++;
+        }
+        else if (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+        {
+            star_pos = pattern_pos++;
+            star_name_pos = name_pos;
+        }
+        else if (star_pos != std::string::npos)
+        {
+            pattern_pos = star_pos + 1;
+            name_pos = ++star_name_pos;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+    {
+        pattern_pos++;
+    }
+    return pattern_pos == pattern.size();
+}
+
+/**
+ * @brief
+ * Lists .dvec, .csv and .dbin files, and .dvec and .csv files compressed with gzip or zstd,
+ * in a directory, or the files matching a pattern such as data/sensor_*.dvec.
+ * Wildcards are allowed in the file name only. The files are sorted by path.
+ * The type of each file comes from the directory listing where the file system provides it, without a stat call.
+ * It throws a runtime exception if no file is found.
+ *
+ * @param[in] input_pattern Path to a directory or a pattern of file paths.
+ * @return std::vector<std::filesystem::directory_entry>
+ */
+std::vector<std::filesystem::directory_entry> list_input_files(const std::string &input_pattern)
+{
+    std::filesystem::path input_path(input_pattern);
+    std::filesystem::path input_dir = input_path;
+    std::string name_pattern = "*";
+    if (std::filesystem::is_directory(input_path) == false)
+    {
+        input_dir = input_path.has_parent_path() ? input_path.parent_path() : std::filesystem::path(".");
+        name_pattern = input_path.filename().string();
+    }
+
+    std::vector<std::filesystem::directory_entry> input_files;
+    if (std::filesystem::is_directory(input_dir) == true)
+    {
+        for (const auto &dir_entry : std::filesystem::directory_iterator(input_dir))
+        {
+            COMPRESSION compression = get_compression(dir_entry.path());
+            std::string extension = remove_compression_extension(dir_entry.path()).extension().string();
+            if (dir_entry.is_regular_file() == true &&
+                (extension == ".dvec" || extension == ".csv" || (extension == ".dbin" && compression == COMPRESSION::NONE)) &&
+                match_wildcard(name_pattern, dir_entry.path().filename().string()) == true)
+            {
+                input_files.push_back(dir_entry);
+            }
+        }
+    }
+
+    if (input_files.empty() == true)
+    {
+        std::string error_message =
+            "INPUT ARGUMENT ERROR - NO INPUT FILE.\n"
+            "There is no .dvec, .csv or .dbin file matching - " + input_pattern + " -.\n";
+        throw std::runtime_error(error_message);
+    }
+    std::sort(input_files.begin(), input_files.end());
+    return input_files;
+}
+
+/**
+ * @brief Checks whether the input of batch mode is a .darc archive instead of a directory or a pattern.
+ *
+ * @param[in] input_pattern Path to a directory, a pattern of file paths or an archive.
+ * @return true When the input is an archive file.
+ * @return false Otherwise.
+ */
+bool is_archive_input(const std::string &input_pattern)
+{
+    std::filesystem::path input_path(input_pattern);
+    return input_path.extension() == ".darc" && std::filesystem::is_regular_file(input_path) == true;
+}
+
+/**
+ * @brief
+ * Packs the data files in a directory, or matching a pattern, into a .darc archive.
+ * Each file becomes a series named by its file name without the extensions, in the order of the paths.
+ *
+ * @param[in] input_pattern Path to a directory or a pattern of file paths.
+ * @param[in] archive_name Path to the archive to be written.
+ * @param[in] run_option Options given through command-line arguments.
+ */
+void run_archive(const std::string &input_pattern, const std::string &archive_name, const RUN_OPTION &run_option)
+{
+    auto time_start = std::chrono::steady_clock::now();
+    std::vector<std::filesystem::directory_entry> input_files = list_input_files(input_pattern);
+    std::vector<std::string> series_names(input_files.size());
+    std::vector<DATA_SET> series_data(input_files.size());
+
+    DATA_IO data_io = make_input_io(run_option, false);
+    for (size_t iter = 0; iter < input_files.size(); iter++)
+    {
+        series_names[iter] = remove_compression_extension(input_files[iter].path()).stem().string();
+        data_io.load_data(input_files[iter].path().string(), series_data[iter]);
+    }
+    data_io.write_archive(archive_name, series_names, series_data);
+
+    double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+    std::cout << "Archived " << input_files.size() << " files into " << archive_name << " in "
+              << std::fixed << std::setprecision(3) << total_time << " s\n"
+              << std::endl;
+}
+
+/**
+ * @brief
+ * Runs robust regression and outlier detection on every given file, or every series of an archive, concurrently and
+ * writes the outputs of each file and summary.csv into output_dir.
+ * @details
+ * Each thread loads a file, computes it and writes its outputs before taking the next file;
+ * therefore, reading and writing of a file overlap with computation of the others.
+ * The outputs of file.dvec are file_outlier_data.dvec, file_inlier_data.dvec and file_result_plot.bmp;
+ * an empty collection of outliers or inliers is not written.
+ * When files of the same stem are given, e.g. file.dvec and file.csv, their outputs are named after
+ * the whole file name instead, e.g. file.csv_outlier_data.dvec, so that they do not overwrite each other.
+ * The series of a .darc archive are taken in the order they are stored, so the archive is read sequentially
+ * through a single mapping; their outliers are written into outlier_data.darc as series of the same names
+ * instead of a file per series, and the inliers are not written.
+ * A file that cannot be loaded or written is reported in the summary and does not stop the others.
+ *
+ * @param[in] reg_method Weight function for robust regression.
+ * @param[in] det_method Outlier detection method.
+ * @param[in] input_pattern Path to a directory, a pattern of file paths or a .darc archive.
+ * @param[in] output_dir Path to the directory the outputs are written to.
+ * @param[in] run_option Options given through command-line arguments.
+ */
+void run_batch(
+    const REGRESSION_METHOD reg_method,
+    const DETECTION_METHOD det_method,
+    const std::string &input_pattern,
+    const std::string &output_dir,
+    const RUN_OPTION &run_option)
+{
+    struct FILE_SUMMARY
+    {
+        size_t num_points = 0;
+        BATCH_RESULT result;
+        std::string error_message;
+    };
+
+    auto time_start = std::chrono::steady_clock::now();
+    std::unique_ptr<DATA_ARCHIVE> data_archive;
+    std::vector<std::string> input_names;
+    std::vector<uintmax_t> file_sizes;
+    if (is_archive_input(input_pattern) == true)
+    {
+        data_archive = std::make_unique<DATA_ARCHIVE>(input_pattern);
+        for (size_t iter = 0; iter < data_archive->size(); iter++)
+        {
+            input_names.emplace_back(data_archive->get_name(iter));
+        }
+        file_sizes.assign(input_names.size(), 0); // the series keep the order of the archive
+    }
+    else
+    {
+        for (const std::filesystem::directory_entry &input_file : list_input_files(input_pattern))
+        {
+            std::error_code size_error;
+            input_names.push_back(input_file.path().string());
+            file_sizes.push_back(input_file.file_size(size_error)); // the only stat of the file before it is opened
+        }
+    }
+    std::filesystem::path output_path(output_dir);
+    std::filesystem::create_directories(output_path);
+
+    // the outputs are named after the stem of the input, or after the whole file name if the stem is not unique
+    std::vector<std::string> output_stems(input_names.size());
+    std::map<std::string, size_t> stem_counts;
+    for (size_t iter = 0; iter < input_names.size(); iter++)
+    {
+        output_stems[iter] = (data_archive != nullptr)
+                                 ? input_names[iter]
+                                 : remove_compression_extension(input_names[iter]).stem().string();
+        stem_counts[output_stems[iter]]++;
+    }
+    for (size_t iter = 0; data_archive == nullptr && iter < input_names.size(); iter++)
+    {
+        if (stem_counts[output_stems[iter]] > 1)
+        {
+            output_stems[iter] = std::filesystem::path(input_names[iter]).filename().string();
+        }
+    }
+
+    std::vector<size_t> file_order(input_names.size());
+    std::iota(file_order.begin(), file_order.end(), size_t(0));
+    std::stable_sort(file_order.begin(), file_order.end(), [&file_sizes](size_t lhs, size_t rhs)
+                     { return file_sizes[lhs] > file_sizes[rhs]; });
+
+    // uncompressed files loaded without validation are read ahead in the order of the tasks while earlier ones are computed;
+    // files larger than max_read_ahead_size are mapped as in the single mode instead of being copied into memory
+    constexpr uintmax_t max_read_ahead_size = uintmax_t(64) << 20;
+    std::vector<size_t> read_order(input_names.size(), SIZE_MAX);
+    std::vector<std::string> read_names;
+    bool is_read_ahead = data_archive == nullptr && run_option.safe_load == 0 && run_option.csv_columns.has_value() == false;
+    for (size_t task_index = 0; is_read_ahead == true && task_index < input_names.size(); task_index++)
+    {
+        size_t file_index = file_order[task_index];
+        if (get_compression(input_names[file_index]) == COMPRESSION::NONE && file_sizes[file_index] <= max_read_ahead_size)
+        {
+            read_order[task_index] = read_names.size();
+            read_names.push_back(input_names[file_index]);
+        }
+    }
+    std::unique_ptr<ASYNC_FILE_READER> file_reader;
+    if (read_names.empty() == false)
+    {
+        file_reader = std::make_unique<ASYNC_FILE_READER>(std::move(read_names));
+    }
+
+    std::vector<FILE_SUMMARY> summaries(input_names.size());
+    std::vector<DATA_SET> archive_outliers((data_archive != nullptr) ? input_names.size() : 0);
+    auto load_file = [&](size_t task_index)
+    {
+        size_t file_index = file_order[task_index];
+        DATA_IO data_io = make_input_io(run_option, false);
+        DATA_SET observed_data;
+        try
+        {
+            if (data_archive != nullptr)
+            {
+                observed_data = data_archive->get_series(file_index);
+            }
+            else if (read_order[task_index] != SIZE_MAX)
+            {
+                data_io.load_data(input_names[file_index], file_reader->get_file(read_order[task_index]), observed_data);
+            }
+            else
+            {
+                data_io.load_data(input_names[file_index], observed_data);
+            }
+            if (run_option.x_range.has_value() == true)
+            {
+                observed_data = observed_data.select_x_range(run_option.x_range->first, run_option.x_range->second);
+            }
+        }
+        catch (const std::exception &error)
+        {
+            summaries[file_index].error_message = error.what();
+        }
+        return observed_data;
+    };
+    auto store_result = [&](size_t task_index, const DATA_SET &observed_data, BATCH_RESULT &&result)
+    {
+        size_t file_index = file_order[task_index];
+        FILE_SUMMARY &summary = summaries[file_index];
+        summary.num_points = observed_data.size();
+        if (summary.error_message.empty() == false)
+        {
+            return;
+        }
+        if (observed_data.empty() == true)
+        {
+            summary.error_message = (run_option.x_range.has_value() == true)
+                                        ? "EMPTY DATA - There is no data point in the file within --x-range."
+                                        : "EMPTY DATA - There is no data point in the file.";
+            return;
+        }
+
+        std::string file_stem = (output_path / output_stems[file_index]).string();
+        try
+        {
+            DATA_IO data_io(IO_MODE::UNSAFE);
+            if (data_archive != nullptr)
+            {
+                archive_outliers[file_index] = result.outliers;
+            }
+            else if (result.outliers.empty() == false)
+            {
+                data_io.write_vec(file_stem + "_outlier_data.dvec" + run_option.compress_suffix, result.outliers);
+            }
+            if (data_archive == nullptr && result.inliers.empty() == false)
+            {
+                data_io.write_vec(file_stem + "_inlier_data.dvec" + run_option.compress_suffix, result.inliers);
+            }
+            if (run_option.write_plot != 0)
+            {
+                FACADE_PLOT plot_result(observed_data, result.outliers, result.inliers, result.m_slope, result.b_intercept);
+                plot_result.draw_all();
+                plot_result.generate_plot(file_stem + "_result_plot.bmp");
+            }
+        }
+        catch (const std::exception &error)
+        {
+            summary.error_message = error.what();
+        }
+        result.outliers = DATA_SET();
+        result.inliers = DATA_SET();
+        summary.result = std::move(result);
+    };
+
+    FACADE_BATCH batch(reg_method, det_method);
+    batch.set_parallel(run_option.num_threads, run_option.chunk_size);
+    batch.proceed_batch(input_names.size(), load_file, store_result);
+
+    if (data_archive != nullptr)
+    {
+        std::vector<std::string> outlier_names;
+        std::vector<DATA_SET> outlier_series;
+        for (size_t iter = 0; iter < input_names.size(); iter++)
+        {
+            if (archive_outliers[iter].empty() == false)
+            {
+                outlier_names.push_back(input_names[iter]);
+                outlier_series.push_back(std::move(archive_outliers[iter]));
+            }
+        }
+        if (outlier_series.empty() == false)
+        {
+            DATA_IO data_io(IO_MODE::UNSAFE);
+            data_io.write_archive((output_path / "outlier_data.darc").string(), outlier_names, outlier_series);
+        }
+    }
+
+    std::ofstream summary_file(output_path / "summary.csv");
+    summary_file << "file,num_points,slope,intercept,iterations,outliers,error\n"
+                 << std::scientific << std::setprecision(16);
+    uint32_t num_failed = 0;
+    for (size_t iter = 0; iter < input_names.size(); iter++)
+    {
+        const FILE_SUMMARY &summary = summaries[iter];
+        std::string error_message = summary.error_message;
+        std::replace(error_message.begin(), error_message.end(), '\n', ' ');
+        std::replace(error_message.begin(), error_message.end(), ',', ';');
+        summary_file << input_names[iter] << ","
+                     << summary.num_points << ","
+                     << summary.result.m_slope << ","
+                     << summary.result.b_intercept << ","
+                     << summary.result.num_iteration << ","
+                     << summary.result.num_outlier << ","
+                     << error_message << "\n";
+        if (summary.error_message.empty() == false)
+        {
+            num_failed++;
+            std::cout << "Failed - " << input_names[iter] << "\n" << summary.error_message << "\n";
+        }
+    }
+    summary_file.close();
+
+    double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+    std::string input_kind = (data_archive != nullptr) ? " series (" : " files (";
+    std::cout << "Processed " << input_names.size() << input_kind << input_names.size() - num_failed << " succeeded, "
+              << num_failed << " failed) in " << std::fixed << std::setprecision(3) << total_time << " s\n"
+              << "Summary - " << (output_path / "summary.csv").string() << "\n"
+              << std::endl;
+}
 
 int main(int argc, char *argv[])
 {
-    if (argc < 4 || argc > 4)
+    if (argc >= 2 && std::string(argv[1]) == "serve")
+    {
+        RUN_OPTION server_option;
+        server_option.num_threads = 0;
+        server_option = validate_run_option(argc, argv, 2, server_option);
+
+        REQUEST_SERVER server(server_option.num_threads, server_option.chunk_size);
+        server.set_io_mode(get_load_mode(server_option, false));
+        if (server_option.csv_columns.has_value() == true)
+        {
+            server.set_csv_columns(server_option.csv_columns.value());
+        }
+        server.serve(std::cin, std::cout);
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "convert")
+    {
+        if (argc != 4)
+        {
+            std::string error_message =
+                "INPUT ARGUMENT ERROR - MISSING INPUT.\n"
+                "Convert mode requires an input file and an output file.\n";
+            throw std::runtime_error(error_message);
+        }
+        DATA_IO data_io(IO_MODE::MAPPED);
+        data_io.convert_data(argv[2], argv[3]);
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "archive")
+    {
+        if (argc < 4)
+        {
+            std::string error_message =
+                "INPUT ARGUMENT ERROR - MISSING INPUT.\n"
+                "Archive mode requires an input directory or pattern and an output archive.\n";
+            throw std::runtime_error(error_message);
+        }
+        run_archive(argv[2], argv[3], validate_run_option(argc, argv, 4));
+        return 0;
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "batch")
+    {
+        if (argc < 6)
+        {
+            std::string error_message =
+                "INPUT ARGUMENT ERROR - MISSING INPUT.\n"
+                "Batch mode requires a weight function, a detection method, an input directory or pattern and an output directory.\n";
+            throw std::runtime_error(error_message);
+        }
+        RUN_OPTION batch_option;
+        batch_option.num_threads = 0;
+        batch_option = validate_run_option(argc, argv, 6, batch_option);
+
+        run_batch(validate_reg_method(argv[2]), validate_det_method(argv[3]), argv[4], argv[5], batch_option);
+        return 0;
+    }
+
+    if (argc < 4)
     {
         std::cout << "The program is designed to perform linear regression and detect outlier.\n\n"
                      "First Input\n"
@@ -18,7 +723,45 @@ int main(int argc, char *argv[])
                      "\tPlease choose one between 'weight' and 'standardized_resdual'\n\n"
 
                      "Third Input\n"
-                     "\tPath to the observed data file.\n\n"
+                     "\tPath to the observed data file (.dvec, .csv or .dbin), or '-' to read the standard input.\n"
+                     "\t.dvec and .csv files compressed with gzip (.dvec.gz) or zstd (.dvec.zst) are also accepted.\n\n"
+
+                     "Compare Mode\n"
+                     "\tUse 'compare' as the first input and a comma-separated list of weight functions (or 'all') as the second input\n"
+                     "\tto print slope, intercept, iterations and time of each weight function on the same data.\n\n"
+
+                     "Server Mode\n"
+                     "\tUse 'serve' as the only input to read requests from standard input and write results to standard output.\n"
+                     "\tRequests are 'fit <weight_func> <detect_func> <num_points> [outliers]' followed by lines of 'x y',\n"
+                     "\t'fit_file <weight_func> <detect_func> <path> [output_dir]' and 'quit'. It uses every hardware thread by default.\n\n"
+
+                     "Batch Mode\n"
+                     "\tUse 'batch' as the first input, followed by the weight function, the detection method,\n"
+                     "\ta directory, a pattern such as 'data/*.dvec' or a .darc archive, and the output directory.\n"
+                     "\tEvery file is processed concurrently and summary.csv is written into the output directory.\n"
+                     "\tThe outliers of the series of an archive are written into outlier_data.darc.\n"
+                     "\tIt uses every hardware thread by default.\n\n"
+
+                     "Archive Mode\n"
+                     "\tUse 'archive' as the first input, followed by a directory or a pattern and an output .darc file,\n"
+                     "\tto pack many small data files into a single archive read by Batch Mode.\n\n"
+
+                     "Convert Mode\n"
+                     "\tUse 'convert' as the first input, followed by an input file and an output file, to convert\n"
+                     "\tbetween .dvec, .csv and .dbin formats. .dbin files are loaded without parsing.\n\n"
+
+                     "Options (optional, after the inputs)\n"
+                     "\t--threads N\tNumber of threads for the regression, 0 uses every hardware thread (default 1)\n"
+                     "\t--chunk N\tNumber of data points processed by a thread at a time, 0 uses the default (8192)\n"
+                     "\t--plot N\t0 does not write result_plot.bmp (default 1)\n"
+                     "\t--safe N\t1 validates input files and reports the line and column of an error (default 0)\n"
+                     "\t--compress C\tgz or zst compresses outlier_data.dvec and inlier_data.dvec (default none)\n"
+                     "\t--columns X,Y\tNames or zero-based indices of the X and Y columns of multi-column .csv files\n"
+                     "\t--format F\tdvec, csv or dbin, the format of the standard input '-' and the standard output (default dvec)\n"
+                     "\t--stdout S\toutliers or inliers writes the data points to the standard output instead of the files,\n"
+                     "\t\t\tand the results are printed to the standard error (default none)\n"
+                     "\t--x-range L,H\tFits, detects and plots only the data points with X in [L, H]; blocks of .dbin files\n"
+                     "\t\t\toutside the range are not read\n\n"
 
                   << std::endl;
 
@@ -26,49 +769,91 @@ int main(int argc, char *argv[])
                      "\tproj_r bisquare standardized_residual observed_data.dvec\n"
                      "Example Input for Windows\n"
                      "\tproj_r.exe bisquare standardized_residual observed_data.dvec\n"
+                     "Example Input with 8 threads\n"
+                     "\tproj_r bisquare standardized_residual observed_data.dvec --threads 8\n"
+                     "Example Input of Compare Mode\n"
+                     "\tproj_r compare all observed_data.dvec\n"
+                     "Example Input of Server Mode\n"
+                     "\tproj_r serve --threads 4\n"
+                     "Example Input of Convert Mode\n"
+                     "\tproj_r convert observed_data.dvec observed_data.dbin\n"
+                     "Example Input of Batch Mode\n"
+                     "\tproj_r batch bisquare standardized_residual 'data/*.dvec' results --plot 0\n"
+                     "Example Input of Archive Mode\n"
+                     "\tproj_r archive 'data/*.dvec' all_series.darc\n"
+                     "\tproj_r batch bisquare standardized_residual all_series.darc results --plot 0\n"
+                     "Example Input in a Pipeline\n"
+                     "\tgenerate_data | proj_r bisquare standardized_residual - --format csv --stdout inliers --plot 0 | next_step\n"
                   << std::endl;
         return 0;
     }
 
-    DATA_IO data_io(IO_MODE::UNSAFE);
-    std::vector<double> x_observed;
-    std::vector<double> y_observed;
+    if (std::string(argv[1]) == "compare")
+    {
+        run_comparison(argv[2], argv[3], validate_run_option(argc, argv, 4));
+        return 0;
+    }
+
     REGRESSION_METHOD reg_method = validate_reg_method(argv[1]);
     DETECTION_METHOD det_method = validate_det_method(argv[2]);
-    data_io.load_vec(argv[3], x_observed, y_observed);
+    RUN_OPTION run_option = validate_run_option(argc, argv, 4);
 
-    FACADE_REGRESSION regression(x_observed, y_observed, reg_method);
+    std::shared_ptr<THREAD_POOL> thread_pool = (run_option.num_threads != 1) ? std::make_shared<THREAD_POOL>(run_option.num_threads) : nullptr;
+    DATA_IO data_io = make_input_io(run_option, thread_pool != nullptr);
+    data_io.set_parallel(thread_pool);
+    DATA_SET observed_data;
+    data_io.load_data(argv[3], observed_data);
+
+    FACADE_REGRESSION regression(observed_data, reg_method);
+    if (thread_pool != nullptr)
+    {
+        regression.set_parallel(thread_pool, run_option.chunk_size);
+    }
+    if (run_option.x_range.has_value() == true)
+    {
+        regression.set_x_range(run_option.x_range->first, run_option.x_range->second);
+        observed_data = regression.get_observed();
+    }
     regression.proceed_regression();
 
     double m_slope = 0;
     double b_intercept = 0;
-    std::vector<double> w_weight;
     regression.get_estimates(m_slope, b_intercept);
-    regression.get_w_weight(w_weight);
-    FACADE_DETECTION outlier_detect(x_observed, y_observed, w_weight, m_slope, b_intercept);
+    FACADE_DETECTION outlier_detect(observed_data, regression.release_w_weight(), m_slope, b_intercept);
     outlier_detect.proceed_detection(det_method);
 
-    uint32_t num_detected_outlier = 0;
-    std::vector<double> x_outlier;
-    std::vector<double> y_outlier;
-    std::vector<double> x_inlier;
-    std::vector<double> y_inlier;
-    num_detected_outlier = outlier_detect.get_num_outlier();
-    outlier_detect.get_outliers(x_outlier, y_outlier);
-    outlier_detect.get_inliers(x_inlier, y_inlier);
+    uint32_t num_detected_outlier = outlier_detect.get_num_outlier();
+    const DATA_SET &outlier_data = outlier_detect.get_outliers();
+    const DATA_SET &inlier_data = outlier_detect.get_inliers();
 
-    data_io.write_vec("outlier_data.dvec", x_outlier, y_outlier);
-    data_io.write_vec("inlier_data.dvec", x_inlier, y_inlier);
+    // With --stdout, the standard output carries only the data points, so the results are printed to the standard error.
+    std::ostream &result_stream = (run_option.stdout_data.empty() == true) ? std::cout : std::cerr;
+    if (run_option.stdout_data.empty() == true)
+    {
+        data_io.write_vec("outlier_data.dvec" + run_option.compress_suffix, outlier_data);
+        data_io.write_vec("inlier_data.dvec" + run_option.compress_suffix, inlier_data);
+    }
+    else
+    {
+        const DATA_SET &stdout_data = (run_option.stdout_data == "outliers") ? outlier_data : inlier_data;
+        if (stdout_data.empty() == false)
+        {
+            data_io.write_data(standard_stream_name, stdout_data);
+        }
+    }
 
-    std::cout << 
+    result_stream << 
         "Computed slope: " << std::scientific << m_slope << "\n"
         "Computed intercept: " << std::scientific << b_intercept << "\n"
-        "Detected outliers: " << num_detected_outlier << " out of " << x_observed.size() << "\n"
+        "Detected outliers: " << num_detected_outlier << " out of " << observed_data.size() << "\n"
         << std::endl;
 
-    FACADE_PLOT plot_result(x_observed, y_observed, x_outlier, y_outlier, x_inlier, y_inlier, m_slope, b_intercept);
-    plot_result.draw_all();
-    plot_result.generate_plot("result_plot.bmp");
+    if (run_option.write_plot != 0)
+    {
+        FACADE_PLOT plot_result(observed_data, outlier_data, inlier_data, m_slope, b_intercept);
+        plot_result.draw_all();
+        plot_result.generate_plot("result_plot.bmp");
+    }
 
     return 0;
 }
\ No newline at end of file